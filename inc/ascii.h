@@ -7,12 +7,21 @@
 //  Constants
 //
 #define ASCII_RENDER_BUF_SIZE   16384   // bytes
+#define ASCII_RENDER_CHUNK_SIZE 16384   // bytes, min size of chunks linked once render buf is full
 #define ASCII_CHAR_BUF_SIZE     8192    // bytes
 #define ASCII_OBJ_BUF_SIZE      32      // asciiobj elements
 
+// glyph arrays that don't fit the char buf come from pools of size classes, each class 4x the previous
+#define ASCII_PAGE_CLASSES      3
+#define ASCII_PAGE_MIN_SIZE     256     // bytes
+#define ASCII_PAGE_COUNT        8       // arrays per class
+
 #define ASCII_MAX_2D_CHARS      ((u16) (ASCII_RENDER_BUF_SIZE / sizeof(ascii2_t)))
 #define ASCII_MAX_3D_CHARS      ((u16) (ASCII_RENDER_BUF_SIZE / sizeof(ascii3_t)))
 
+// char buf occupancy bitmap, sized for the smaller 2D glyphs
+#define ASCII_CHAR_MAP_WORDS    ((ASCII_CHAR_BUF_SIZE / sizeof(ascii2_t) + 63) / 64)
+
 #define ASCII_RENDER_MODE_2D    0
 #define ASCII_RENDER_MODE_3D    1
 #define ASCII_RENDER_UNINIT     2
@@ -22,30 +31,43 @@
 #define ASCII_OBJ_2D            ASCII_RENDER_MODE_2D
 #define ASCII_OBJ_3D            ASCII_RENDER_MODE_3D
 
+// 2D glyph positions are fixed point, 1/8 px steps within +-4096 px
+#define ASCII_POS_FRAC_BITS     3
+#define ASCII_POS_ONE           (1 << ASCII_POS_FRAC_BITS)
+#define ASCII_POS_MAX           (32767.0f / ASCII_POS_ONE)
+
+// glyph colors are indices into a shared palette, colors are added on first use
+#define ASCII_PALETTE_SIZE      256
+
+#define ASCII_GLYPH_VISIBLE     0x01    // glyph flags
+
 //
 //  Typedefs
 //
 typedef i32 char2Idx;
 typedef i32 char3Idx;
 typedef struct pageinfo_s pageinfo_t;
+typedef struct renderchunk_s renderchunk_t;
 
-// ascii char in 2D space
+// ascii char in 2D space, 8 bytes, converted to screen position and color when submitted
 typedef struct ascii2_s {
-    f32 xpos;       // local x position of char
-    f32 ypos;       // local y position of char
-    u32 color;
-    u16 visible;
-    u16 charID;
+    Sint16 xpos;    // local x position of char, fixed point, see asciiPosToFixed
+    Sint16 ypos;    // local y position of char
+    Uint8  color;   // palette index
+    Uint8  charID;
+    Uint8  flags;   // each char has its own visibility flag so renderbuf can be processed directly
+    Uint8  pad;
 } ascii2_t;
 
-// ascii char in 3D space
+// ascii char in 3D space, 16 bytes, position fills the first 12
 typedef struct ascii3_s {
-    f32 xpos;
-    f32 ypos;
-    f32 zpos;
-    u32 color;
-    u32 visible;    // each char has its own visibility flag so renderbuf can be processed directly
-    u32 charID;
+    f32    xpos;
+    f32    ypos;
+    f32    zpos;
+    Uint8  color;   // palette index
+    Uint8  charID;
+    Uint8  flags;
+    Uint8  pad;
 } ascii3_t;
 
 // info needed to allocate 2D char
@@ -73,11 +95,16 @@ typedef struct asciiobj_s {
     f32 ypos;       // global y offset of object
     f32 zpos;       // global z offset of object (only for 3D)
 
+    vec2f_t bmin;   // local bounding box of 2D objects, glyph size included
+    vec2f_t bmax;
+
     union {
         ascii2_t* ascii2;
         ascii3_t* ascii3;
     } data;
 
+    pageinfo_t* page;   // paged memory record, NULL if chars are in char buf
+
 } asciiobj_t;
 
 // linked list for paged memory
@@ -85,9 +112,49 @@ struct pageinfo_s {
     void*       ptr;
     u32         len;
     u32         type;
+    pageinfo_t* prev;
     pageinfo_t* next;
 };
 
+// block of render queue, render buf is the first one, chunks are kept for later frames
+struct renderchunk_s {
+    void*          mem;
+    u32            size;    // bytes
+    u32            used;    // bytes
+    renderchunk_t* next;
+};
+
+// render queue sizing info, counted since init
+typedef struct asciiqueuestats_s {
+    u32 peakChars;          // most glyphs queued at once
+    u32 chunks;             // including render buf
+    u64 capacity;           // bytes in all chunks
+    u64 spills;             // times an object went to the next chunk because the current one was full
+    u64 bytesCopied;
+} asciiqueuestats_t;
+
+// palette, entries are never removed
+extern Uint32 g_asciiPalette[ASCII_PALETTE_SIZE];
+
+// char buf and its slot occupancy map, read by flappy_bench to check the slot allocator
+extern void* g_charbuf;
+extern Uint64 g_charMap[ASCII_CHAR_MAP_WORDS];
+
+//
+//  Inline functions
+//
+static inline Sint16 asciiPosToFixed(f32 pos)
+{
+    pos = SDL_max(-ASCII_POS_MAX, SDL_min(pos, ASCII_POS_MAX));
+
+    return (Sint16) (pos >= 0.0f ? pos * ASCII_POS_ONE + 0.5f : pos * ASCII_POS_ONE - 0.5f);
+}
+
+static inline f32 asciiPosFromFixed(Sint16 pos)
+{
+    return (f32) pos * (1.0f / ASCII_POS_ONE);
+}
+
 //
 //  Public funtions
 //
@@ -104,19 +171,32 @@ void renderAsciiObject2D(asciiobj_t* object);
 void renderAsciiObject3D(asciiobj_t* object);
 void renderAsciiObjectDirect2D(asciiobj_t* object);
 void renderAsciiObjectDirect3D(asciiobj_t* object);
+void asciiGetQueueStats(asciiqueuestats_t* stats);
+const renderchunk_t* asciiGetRenderQueue(void);
+
+void asciiCopyOffset2D(ascii2_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy);
+void asciiCopyOffset3D(ascii3_t* dst, const ascii3_t* src, u32 len, f32 dx, f32 dy, f32 dz);
+const char* asciiCopyKernelName(void);
 
 asciiobj_t* asciiObject2D(const vec2f_t* positions, const u32* colors, const u32* chars, u64 len);
 asciiobj_t* asciiObject3D(const vec3f_t* positions, const u32* colors, const u32* chars, u64 len);
 asciiobj_t* asciiObject2DIStruct(const ascii2info_t* info, u64 len);
 asciiobj_t* asciiObject3DIStruct(const ascii3info_t* info, u64 len);
 
+void removeAsciiObject(asciiobj_t* object);
+
+Uint8 asciiPaletteIndex(u32 color);
+
+void asciiUpdateBounds2D(asciiobj_t* object);
+bool asciiObjectOnScreen2D(const asciiobj_t* object);
+
 asciiobj_t* getAsciiObj(u32 type, u32 len);
-bool getAsciiObjMem(void** dst, u32 type, u32 len);
+pageinfo_t* getAsciiObjMem(void** dst, u32 type, u32 len);
 void renderBuf2D(const ascii2_t* buf, u64 len, f32 dx, f32 dy);
 void renderBuf3D(const ascii3_t* buf, u32 len, f32 dx, f32 dy, f32 dz);
 
-void memPage(void* ptr, u32 type, u32 len);
-void removeMemPage(void* ptr);
+pageinfo_t* memPage(void* ptr, u32 type, u32 len);
+void removeMemPage(pageinfo_t* page);
 void freePages(void);
 
 /*
@@ -0,0 +1,63 @@
+#ifndef ASCII3D_H
+#define ASCII3D_H
+
+#include <main.h>
+#include <ascii.h>
+
+//
+//  Constants
+//
+#define ASCII3D_MIN_CAPACITY    4096    // glyphs, scratch doubles when full and is kept between frames
+#define ASCII3D_DEPTH_MAX       0xffff  // depth keys are 16 bit, radix sorted in two 8 bit passes
+#define ASCII3D_DEFAULT_FOV     60.0f   // vertical, degrees
+
+//
+//  Typedefs
+//
+
+// x right, y down, looks along +z at zero yaw and pitch, angles in radians
+typedef struct asciicamera_s {
+    vec3f_t pos;
+    f32 yaw;        // around y, positive turns right
+    f32 pitch;      // around x, positive looks up
+    f32 fov;        // vertical field of view, degrees
+    f32 nearZ;      // view depth range, glyphs outside are culled
+    f32 farZ;
+} asciicamera_t;
+
+// projected glyph, position is the top left corner in screen space
+typedef struct ascii3dglyph_s {
+    f32    xpos;
+    f32    ypos;
+    f32    scale;
+    Uint32 depth;   // 0 at far plane, ASCII3D_DEPTH_MAX at near plane
+    Uint32 color;
+    Uint32 charID;
+} ascii3dglyph_t;
+
+// counts of the last flushed batch
+typedef struct ascii3dstats_s {
+    u32 submitted;
+    u32 culled;     // invisible, behind near, beyond far or off screen
+    u32 drawn;
+    u32 capacity;   // glyphs scratch can hold without growing
+} ascii3dstats_t;
+
+//
+//  Public functions
+//
+void ascii3DDefaultCamera(asciicamera_t* cam);
+void ascii3DSetCamera(const asciicamera_t* cam);
+void ascii3DGetCamera(asciicamera_t* cam);
+
+void ascii3DBegin(void);
+void ascii3DSubmit(const ascii3_t* buf, u32 len, f32 dx, f32 dy, f32 dz);
+u32  ascii3DSort(void);
+void ascii3DFlush(void);
+void ascii3DCleanup(void);
+
+const ascii3dglyph_t* ascii3DGetGlyph(u32 order);
+void ascii3DGetStats(ascii3dstats_t* stats);
+const char* ascii3DKernelName(void);
+
+#endif
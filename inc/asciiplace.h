@@ -0,0 +1,40 @@
+#ifndef ASCIIPLACE_H
+#define ASCIIPLACE_H
+
+#include <main.h>
+#include <ascii.h>
+#include <render.h>
+
+//
+//  Constants
+//
+#define ASCII_GLYPH_EXTENT      (RENDER_GLYPH_SIZE * ASCII_RENDER_SCALE)   // px, drawn size of one glyph
+#define ASCII_PLACE_BATCH       256     // glyphs placed per kernel call by renderBuf2D
+
+#define ASCII_PLACE_KERNEL_SCALAR   0
+#define ASCII_PLACE_KERNEL_SSE2     1
+#define ASCII_PLACE_KERNEL_AVX2     2
+#define ASCII_PLACE_KERNELS         3
+
+//
+//  Typedefs
+//
+
+// glyph ready to draw, dst is rounded to whole pixels like renderCharColor placed it, never -0
+typedef struct asciiplaced_s {
+    SDL_FRect dst;
+    Uint32    color;    // RGBA, already looked up in palette
+    Uint32    charID;
+} asciiplaced_t;
+
+//
+//  Public functions
+//
+u32 asciiPlace2D(asciiplaced_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy);
+
+bool asciiPlaceSetKernel(u32 kernel);
+u32  asciiPlaceGetKernel(void);
+bool asciiPlaceKernelSupported(u32 kernel);
+const char* asciiPlaceKernelName(u32 kernel);
+
+#endif
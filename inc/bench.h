@@ -0,0 +1,47 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <main.h>
+
+//
+//  Constants
+//
+#define BENCH_MAX_SAMPLES       4096    // timed iterations kept per benchmark
+
+//
+//  Typedefs
+//
+typedef struct benchresult_s {
+    const char* name;
+    const char* unit;       // what count counts
+    u64 count;              // items processed
+    u64 iterations;
+    u64 totalNS;
+    u64 avgNS;              // per iteration
+    u64 p50NS;
+    u64 p99NS;
+} benchresult_t;
+
+// per iteration times of the running benchmark, ns
+extern u64 g_bSamples[BENCH_MAX_SAMPLES];
+
+//
+//  Public functions
+//
+benchresult_t* benchAddResult(const char* name, const char* unit);
+void benchReport(const char* name, const char* unit, u32 iterations, u64 itemsPerIter);
+
+// mark run as failed, flappy_bench exits with 1
+void benchFail(const char* msg);
+
+// benchmark modules, scale multiplies iteration counts
+void benchMemtrack(u32 scale);
+void benchMemtrackThreads(u32 scale);
+void benchAsciiKernels(u32 scale);
+void benchAsciiPlace(u32 scale);
+void benchAscii3D(u32 scale);
+
+// consistency checks without timing, fail the run on mismatch
+void checkWorldBatch(u32 scale);
+
+#endif
@@ -25,9 +25,12 @@ extern size_t g_memAllocated;
 //  LINUS' UNIVERSAL MEMORY TRACKING LIBRARY                                  //
 //                                                                            //
 //  MTRACK_BUF_SIZE:                                                          //
-//  Initial size of memtrack buffers                                          //
-//  Memtrack uses up to 3 buffers depending on operation mode                 //
-//  Buffer sizes will be increased automatically if necessary                 //
+//  Initial size of the live block hash table, rounded up to a power of 2     //
+//  The table is grown automatically if necessary                             //
+//                                                                            //
+//  MTRACK_FREE_SET_SIZE:                                                     //
+//  Number of recently freed pointers remembered to detect double frees       //
+//  Oldest pointers are forgotten first, lookups are hashed                   //
 //                                                                            //
 //  Memtrack control modes:                                                   //
 //                                                                            //
@@ -56,12 +59,33 @@ extern size_t g_memAllocated;
 //  Unless MTRACK_MANUAL_CLEANUP is defined, allocated memory will be         //
 //  freed automatically at program exit                                       //
 //                                                                            //
+//  Arenas:                                                                   //
+//  memArenaAlloc() hands out memory with a pointer bump, everything is       //
+//  released at once by memArenaReset(), arena blocks count as allocated      //
+//  memory and are available in every mode including release                  //
+//  memFrameAlloc() uses the frame arena, reset once per frame                //
+//                                                                            //
+//  Pools:                                                                    //
+//  Fixed number of equally sized elements, alloc and free pop and push a    //
+//  free list, storage is cache line aligned                                  //
+//                                                                            //
+//  Thread safety:                                                            //
+//  Alloc, realloc and free may be called from any thread, each thread keeps  //
+//  its own block records, blocks can be freed by a different thread          //
+//  Choose the law before other threads start allocating, cleanup only after  //
+//  they stopped, memReport() merges the records of all threads               //
+//                                                                            //
 // ========================================================================== //
 
 //
 //  Constants
 //
 #define MTRACK_BUF_SIZE         256
+#define MTRACK_FREE_SET_SIZE    1024
+
+#define MTRACK_ARENA_ALIGN      16      // power of 2, alignment of arena allocations
+#define MTRACK_FRAME_ARENA_SIZE 16384   // initial size of frame arena in bytes
+#define MTRACK_CACHE_LINE       64      // alignment of pool storage
 
 // Max string len used to store information about freed pointers in debug mode
 #define MTRACK_MAX_STRING_LEN   64
@@ -81,6 +105,26 @@ typedef struct mblock_s {
     size_t size;
 } mblock_t;
 
+// Arenas are not thread-safe, use one per thread
+typedef struct marena_s {
+    void* block;        // current block, starts with pointer to previous block
+    size_t size;        // usable bytes in current block
+    size_t used;        // bytes used in current block
+    size_t total;       // bytes handed out since last reset
+    size_t peak;        // max total of any reset cycle
+} marena_t;
+
+// Pools are not thread-safe either
+typedef struct mpool_s {
+    void* mem;          // allocated block, elements start at next cache line
+    char* base;
+    void* freeList;     // free elements store pointer to next free element
+    size_t stride;      // element size, elements never straddle a cache line
+    size_t count;
+    size_t used;
+    size_t peak;
+} mpool_t;
+
 //
 //  Dont use these functions
 //
@@ -90,6 +134,21 @@ void  memtrackChangeLaw_Implementation(control_law law);
 void  memtrackCleanup_Implementation(void);
 void  memtrackSetWarning_Implementation(size_t size);
 void  memtrackSetLimit_Implementation(size_t size);
+void  memtrackReport_Implementation(void);
+
+marena_t* memtrackArenaCreate_Implementation(size_t size);
+void* memtrackArenaAlloc_Implementation(marena_t* arena, size_t size);
+void  memtrackArenaReset_Implementation(marena_t* arena);
+void  memtrackArenaDestroy_Implementation(marena_t* arena);
+void* memtrackFrameAlloc_Implementation(size_t size);
+void  memtrackFrameReset_Implementation(void);
+void  memtrackFrameDestroy_Implementation(void);
+
+mpool_t* memtrackPoolCreate_Implementation(size_t elemSize, size_t count);
+void* memtrackPoolAlloc_Implementation(mpool_t* pool);
+void  memtrackPoolFree_Implementation(mpool_t* pool, void* ptr);
+void  memtrackPoolReset_Implementation(mpool_t* pool);
+void  memtrackPoolDestroy_Implementation(mpool_t* pool);
 void* memtrackAllocate_Implementation(size_t size);
 void* memtrackAllocateInitialize_Implementation(size_t size, size_t count);
 void* memtrackAllocateSet_Implementation(size_t size, unsigned char value);
@@ -105,6 +164,25 @@ void  memtrackFree_Debug(void* ptr, const char* filename, unsigned linenum);
 //
 //  Use these functions
 //
+// Arenas are compiled in every mode
+#define memArenaCreate( size ) memtrackArenaCreate_Implementation(size)
+#define memArenaAlloc( arena, size ) memtrackArenaAlloc_Implementation(arena, size)
+#define memArenaReset( arena ) memtrackArenaReset_Implementation(arena)
+#define memArenaDestroy( arena ) memtrackArenaDestroy_Implementation(arena)
+
+// Frame arena, memory is valid until memFrameReset() at the end of the frame
+#define memFrameAlloc( size ) memtrackFrameAlloc_Implementation(size)
+#define memFrameReset() memtrackFrameReset_Implementation()
+#define memFrameDestroy() memtrackFrameDestroy_Implementation()
+
+// Pools are compiled in every mode, alloc returns NULL once all elements are in use
+#define memPoolCreate( size, count ) memtrackPoolCreate_Implementation(size, count)
+#define memPoolCreateType( type, count ) memtrackPoolCreate_Implementation(sizeof(type), count)
+#define memPoolAlloc( pool ) memtrackPoolAlloc_Implementation(pool)
+#define memPoolFree( pool, ptr ) memtrackPoolFree_Implementation(pool, ptr)
+#define memPoolReset( pool ) memtrackPoolReset_Implementation(pool)
+#define memPoolDestroy( pool ) memtrackPoolDestroy_Implementation(pool)
+
 #if defined MTRACK_DEBUG || defined R_DEBUG
     // Memtrack functions will only be compiled if debug mode is defined
     #define memSetup( lw, alc, rlc, fr, mem ) memtrackSetup_Implementation(lw,alc,rlc,fr,mem)
@@ -112,6 +190,7 @@ void  memtrackFree_Debug(void* ptr, const char* filename, unsigned linenum);
     #define memCleanup() memtrackCleanup_Implementation()
     #define memWarn( x ) memtrackSetWarning_Implementation(x)
     #define memLimit( x ) memtrackSetLimit_Implementation(x)
+    #define memReport() memtrackReport_Implementation()
 
 #endif
 
@@ -156,6 +235,7 @@ void  memtrackFree_Debug(void* ptr, const char* filename, unsigned linenum);
     #define memCleanup() ((void)0)
     #define memWarn( x ) ((void)0)
     #define memLimit( x ) ((void)0)
+    #define memReport() ((void)0)
 
     #define memAlloc( x ) malloc(x)
     #define memAllocCount( x, y ) malloc(x * y)
@@ -6,14 +6,15 @@
 #define R_DEBUG
 #define RDEBUG_BREAK_EXIT
 #define MTRACK_DEBUG
+#define R_PROFILE
 
 #define WINDOW_WIDTH    1280
 #define WINDOW_HEIGHT   720
 
 #define WINDOW_SCALE    (1.0f)
 
-#define FIXED_FRAMETIME 4
-#define MENU_FRAMETIME  17
+#define RENDER_FRAMETIME    16  // ms, game frames if the display refresh rate is unknown
+#define MENU_FRAMETIME      17
 
 #define INTERPOLATION_LINEAR    0
 #define INTERPOLATION_NONE      1
@@ -41,6 +42,7 @@ typedef struct texture_s {
     SDL_Texture* sdltex;
     u16 width;
     u16 height;
+    u32 color;      // color mod, applied as vertex color
 } texture_t;
 
 typedef struct texinfo_s {
@@ -0,0 +1,37 @@
+#ifndef PACER_H
+#define PACER_H
+
+#include <main.h>
+
+//
+//  Constants
+//
+#define PACER_SPIN_NS           500000      // busy wait only for the last 0.5 ms
+#define PACER_MIN_SLEEP_NS      100000      // don't bother sleeping for less
+
+//
+//  Typedefs
+//
+typedef struct pacerstats_s {
+    u64 frames;
+    u64 late;               // frames that overshot their deadline by at least one interval
+    u64 resyncs;            // late frames that were two or more intervals behind, missed frames are dropped
+    u64 overshootMax;       // ns
+    u64 overshootTotal;     // ns
+    i64 drift;              // ns behind ideal schedule, rebased on reset and resync so dropped frames don't count
+} pacerstats_t;
+
+//
+//  Public functions
+//
+void initPacer(u64 intervalNS);
+void pacerReset(void);
+void pacerSetInterval(u64 intervalNS);
+u64  pacerGetInterval(void);
+
+u64  pacerWait(void);
+
+void pacerGetStats(pacerstats_t* stats);
+void pacerLogStats(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <main.h>
+
+//
+//  Constants
+//
+#define PROF_MAX_FRAMES     256     // frames kept in history ring buffer
+#define PROF_MAX_DEPTH      16      // max zone nesting
+
+// zones, order is also overlay row order
+#define PROF_ZONE_UPDATE    0       // updateWorld, physics ticks and world rendering
+#define PROF_ZONE_CLOUDS    1
+#define PROF_ZONE_PIPES     2
+#define PROF_ZONE_BIRD      3
+#define PROF_ZONE_BUF2D     4       // ascii glyph submission
+#define PROF_ZONE_PRESENT   5       // command list flush and SDL_RenderPresent
+#define PROF_MAX_ZONES      6
+
+// counters, summed per frame, shown below the zones
+#define PROF_COUNTER_QUEUE_CHARS    0   // glyphs written to ascii render queue
+#define PROF_COUNTER_QUEUE_BYTES    1   // bytes copied into ascii render queue
+#define PROF_COUNTER_QUEUE_SPILLS   2   // ascii render queue chunks linked because the previous one was full
+#define PROF_COUNTER_CULLED_OBJECTS 3   // ascii objects skipped because their bounds are off screen
+#define PROF_COUNTER_DRAW_CALLS     4   // SDL draw calls of the flushed command list
+#define PROF_COUNTER_STATE_CHANGES  5   // draw color sets and texture switches between draw calls
+#define PROF_COUNTER_TEXT_HITS      6   // cached strings drawn from their baked slot
+#define PROF_COUNTER_TEXT_MISSES    7   // cached strings baked or drawn glyph by glyph
+#define PROF_MAX_COUNTERS           8
+
+//
+//  Typedefs
+//
+typedef struct profstats_s {
+    u32 frames;             // frames in history
+    u64 min;                // ns
+    u64 avg;                // ns
+    u64 p50;                // ns
+    u64 p99;                // ns
+    u64 max;                // ns
+} profstats_t;
+
+//
+//  Dont use these functions
+//
+void profBegin_Implementation(u32 zone);
+void profEnd_Implementation(u32 zone);
+void profCount_Implementation(u32 counter, u32 n);
+
+//
+//  Use these functions
+//
+#ifdef R_PROFILE
+    // zones can nest but must be closed in reverse order, time is inclusive of nested zones
+    #define profBegin( zone ) profBegin_Implementation(zone)
+    #define profEnd( zone ) profEnd_Implementation(zone)
+    #define profCount( counter, n ) profCount_Implementation(counter, n)
+#else
+    #define profBegin( zone ) ((void)0)
+    #define profEnd( zone ) ((void)0)
+    #define profCount( counter, n ) ((void)0)
+#endif
+
+void initProfiler(void);
+void profFrame(void);
+
+void profToggleOverlay(void);
+void profDrawOverlay(void);
+
+void profGetZoneStats(u32 zone, profstats_t* stats);
+void profGetFrameStats(profstats_t* stats);
+void profGetCounterStats(u32 counter, profstats_t* stats);
+void profLogStats(void);
+
+#endif
\ No newline at end of file
@@ -26,26 +26,73 @@
 #define MAX_TEXTURES        4
 #define MAX_ASCII_TEXTURES  128
 
+#define RENDER_GLYPH_SIZE       64      // px, glyph bitmaps are square
+#define RENDER_ATLAS_COLS       16      // glyphs per atlas row
+#define RENDER_MAX_BATCH_GLYPHS 4096    // glyphs and texture quads per geometry call
+#define RENDER_MAX_BATCH_RECTS  1024    // rects per SDL_RenderFillRects / SDL_RenderRects call
+#define RENDER_MAX_COMMANDS     16384   // draws recorded per frame, list is flushed early when full
+
+// draw layers, lower layers are drawn first, within a layer commands are grouped by texture and color
+#define RENDER_LAYER_BACKGROUND     0   // clouds
+#define RENDER_LAYER_PIPES          1
+#define RENDER_LAYER_BIRD           2
+#define RENDER_LAYER_HITBOXES       3
+#define RENDER_LAYER_HUD            4   // default, reset after every frame
+#define RENDER_LAYER_OVERLAY        5   // profiler panel
+#define RENDER_LAYER_OVERLAY_TEXT   6
+#define RENDER_LAYER_OVERLAY_TOP    7
+#define RENDER_LAYERS               8
+
 #define RENDER_TXT_MAX_LEN  256
 
+// cached strings are baked once into slots of one target texture and drawn as a single quad while unchanged
+#define RENDER_TEXT_ATLAS_SIZE  1024                                            // px, square
+#define RENDER_TEXT_SLOT_HEIGHT RENDER_GLYPH_SIZE                               // px, strings up to scale 1
+#define RENDER_TEXT_SLOTS       (RENDER_TEXT_ATLAS_SIZE / RENDER_TEXT_SLOT_HEIGHT)
+#define RENDER_TEXT_CACHE_LEN   64                                              // longest cached string + 1
+#define RENDER_U64_MAX_DIGITS   20
+
 #define TEXTURE_LOGO    0
 #define TEXTURE_BIRD    1
 #define TEXTURE_PIPE    2
 #define TEXTURE_CLOUD   3
 
+// totals since initRenderer or renderResetStats
+typedef struct renderstats_s {
+    u64 frames;
+    u64 commands;
+    u64 drawCalls;
+    u64 stateChanges;               // draw color sets and texture switches between draw calls
+    u64 immediateDrawCalls;         // same for drawing every command when it is recorded
+    u64 immediateStateChanges;
+    u64 overflows;                  // early flushes because the command list was full
+    u64 textHits;                   // cached strings drawn from their baked slot
+    u64 textMisses;                 // baked, or drawn glyph by glyph because they can't be cached
+    u64 textEvictions;              // least recently drawn strings replaced
+} renderstats_t;
+
 void initRenderer(void);
 void cleanupRenderer(void);
 
 void clearScreen(u32 color);
 void setColor(u32 color);
+void renderSetLayer(u32 layer);
+void renderFlush(void);
+void presentScreen(void);
+
+void renderGetStats(renderstats_t* stats);
+void renderResetStats(void);
 
 void renderRectangleColor(f32 xpos, f32 ypos, f32 width, f32 height, u32 color);
 void renderRectangle(f32 xpos, f32 ypos, f32 width, f32 height);
+void renderRectangles(const SDL_FRect* rects, u32 count);
 void renderHitbox(f32 xpos, f32 ypos, f32 width, f32 height);
 
 bool loadTextures(const texinfo_t* textures, u32 numTextures);
 bool loadTexture(const char* path, bool noInterpolation, u8 textureID);
 bool loadCharTextures(const char* path, u32 numChars);
+bool loadBlankTexture(u16 width, u16 height, u8 textureID);
+bool loadBlankCharTextures(u32 numChars);
 void setTextureColor(u32 textureID, u32 color);
 
 void renderTexture(i16 xpos, i16 ypos, u16 scale, u16 textureID);
@@ -54,10 +101,16 @@ void renderTextureRotate(i16 xpos, i16 ypos, u16 rotation, u8 scale, u8 textureI
 
 void renderChar(i16 xpos, i16 ypos, f32 scale, char charID);
 void renderCharColor(i16 xpos, i16 ypos, f32 scale, u32 color, char charID);
+void renderCharRect(const SDL_FRect* dst, u32 color, char charID);
 void renderStr(i16 xpos, i16 ypos, f32 scale, const char* str);
 void renderStrColor(i32 xpos, i32 ypos, f32 scale, u32 color, const char* str);
 void renderStrColorFmt(i32 xpos, i32 ypos, f32 scale, u32 color, const char* fmt, ... );
 void renderStrColorCentered(i64 ypos, f32 scale, u32 color, const char* str);
 void renderStrColorFmtCentered(i64 ypos, f32 scale, u32 color, const char* fmt, ... );
+void renderStrCached(i32 xpos, i32 ypos, f32 scale, u32 color, const char* str);
+void renderStrCachedCentered(i64 ypos, f32 scale, u32 color, const char* str);
+void renderTextCacheClear(void);
+
+u32 renderFormatU64(char* dst, u64 value, u32 width);
 
 #endif
\ No newline at end of file
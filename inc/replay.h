@@ -0,0 +1,48 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <main.h>
+
+//
+//  Constants
+//
+#define REPLAY_MAGIC        0x52504c46  // "FLPR"
+#define REPLAY_VERSION      1
+
+#define REPLAY_EV_NONE      0
+#define REPLAY_EV_RESET     1           // new game, arg is the seed
+#define REPLAY_EV_UPDRAFT   2
+#define REPLAY_EV_GODMODE   3           // god mode toggled
+#define REPLAY_EV_END       4
+
+#define REPLAY_FF_CHUNK     50000       // max ticks per frame while fast forwarding
+
+#define REPLAY_STATE_OFF    0
+#define REPLAY_STATE_REC    1
+#define REPLAY_STATE_PLAY   2
+
+//
+//  Log format, little endian:
+//
+//  header  u32 magic, u32 version, u32 tick rate, u8 initial god mode
+//  event   u8 type, varint tick (world tick the event applies to), u64 seed for RESET only
+//
+//  Ticks restart at 0 after every RESET, events are in the order they happened
+//
+
+//
+//  Public functions
+//
+bool replayStartRecording(const char* path, u32 tickRate, bool godMode);
+bool replayStartPlayback(const char* path, u32* tickRate, bool* godMode);
+void replayStop(void);
+
+u32  replayState(void);
+
+void replayRecord(u32 type, u64 tick, u64 arg);
+u32  replayPoll(u64 tick, u64* arg);
+
+void replaySetFastForward(u64 tick);
+u64  replayFastForwardLeft(u64 totalTicks);
+
+#endif
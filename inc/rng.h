@@ -0,0 +1,72 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <main.h>
+
+//
+//  Typedefs
+//
+
+// xoshiro128** state, Uint32 because u32 is 64 bit on LP64 targets
+typedef struct rng_s {
+    Uint32 s[4];
+} rng_t;
+
+// same generator for many independent streams in struct-of-arrays form, lane i uses s[0..3][i]
+typedef struct rnglanes_s {
+    Uint32* s[4];
+} rnglanes_t;
+
+//
+//  Public functions
+//
+void rngSeed(rng_t* rng, u64 seed);
+
+void rngLanesSeed(rnglanes_t* lanes, u32 count, u64 seed);
+void rngLanesFillRange(rnglanes_t* lanes, u32 first, u32 count, f32* dst, i32 lbound, i32 ubound);
+
+//
+//  Inline functions
+//
+static inline Uint32 rngRotl(Uint32 x, u32 k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline Uint32 rngNext(rng_t* rng)
+{
+    Uint32* s = rng->s;
+    Uint32 result = rngRotl(s[1] * 5, 7) * 9;
+    Uint32 t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rngRotl(s[3], 11);
+
+    return result;
+}
+
+// integer in [lbound, ubound) as float, multiply-shift instead of modulo
+static inline f32 rngRange(rng_t* rng, i32 lbound, i32 ubound)
+{
+    return (f32) (lbound + (i32) (((u64) rngNext(rng) * (u64) (ubound - lbound)) >> 32));
+}
+
+static inline f32 rngLaneRange(rnglanes_t* lanes, u32 lane, i32 lbound, i32 ubound)
+{
+    rng_t tmp = {{lanes->s[0][lane], lanes->s[1][lane], lanes->s[2][lane], lanes->s[3][lane]}};
+
+    f32 result = rngRange(&tmp, lbound, ubound);
+
+    lanes->s[0][lane] = tmp.s[0];
+    lanes->s[1][lane] = tmp.s[1];
+    lanes->s[2][lane] = tmp.s[2];
+    lanes->s[3][lane] = tmp.s[3];
+
+    return result;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef ROLLOUT_H
+#define ROLLOUT_H
+
+#include <main.h>
+#include <worldbatch.h>
+
+//
+//  Constants
+//
+#define ROLLOUT_MAX_THREADS     64
+#define ROLLOUT_STD_SHARD_SIZE  256     // games per task
+
+//
+//  Typedefs
+//
+
+// fills one action per env, called concurrently from worker threads
+typedef void (*rolloutpolicy_t)(const worldbatch_t* batch, u8* actions, void* userdata);
+
+typedef struct rolloutcfg_s {
+    u32 games;
+    u32 ticks;              // ticks simulated per game
+    u32 shardSize;          // games per task, 0 for ROLLOUT_STD_SHARD_SIZE
+    u32 threads;            // 0 for all logical cores
+    u32 tickRate;
+    u32 seed;
+
+    rolloutpolicy_t policy;
+    void* userdata;
+} rolloutcfg_t;
+
+typedef struct rolloutstats_s {
+    u32 threads;
+    u32 shards;
+
+    u64 envSteps;
+    u64 episodes;
+    u64 scoreTotal;
+    u32 scoreMax;
+    u64 checksum;           // hash of final game states in shard order, same for any thread count
+
+    u64 elapsedNS;
+    f64 stepsPerSec;
+
+    u64 workerBusyNS[ROLLOUT_MAX_THREADS];
+    u32 workerTasks[ROLLOUT_MAX_THREADS];
+    u32 workerSteals[ROLLOUT_MAX_THREADS];
+} rolloutstats_t;
+
+//
+//  Public functions
+//
+
+// games run on the batch physics of worldbatch.h, not on the worldsim functions
+bool rolloutRun(const rolloutcfg_t* cfg, rolloutstats_t* stats);
+void rolloutLogStats(const rolloutstats_t* stats);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <main.h>
+#include <worldsim.h>
+
+//
+//  Constants
+//
+#define SIM_ACTION_NONE     0
+#define SIM_ACTION_FLAP     1
+
+//
+//  Typedefs
+//
+typedef struct sim_s sim_t;
+
+// what an agent gets to see after each step
+typedef struct simobs_s {
+    f32 birdY;          // top of bird hitbox
+    f32 birdSpeed;      // px/s, positive is down
+    f32 pipeDX;         // distance from bird to left edge of next pipe pair
+    f32 gapTop;         // y of lower edge of next top pipe
+    f32 gapBot;         // y of upper edge of next bottom pipe
+    u32 score;
+    u64 ticks;
+    bool done;
+} simobs_t;
+
+//
+//  Public functions
+//
+sim_t* simCreate(u32 tickRate, u64 seed);
+void   simDestroy(sim_t* sim);
+void   simSeed(sim_t* sim, u64 seed);
+void   simReset(sim_t* sim);
+
+bool   simStep(sim_t* sim, u32 action);
+void   simObserve(const sim_t* sim, simobs_t* obs);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef WORLDBATCH_H
+#define WORLDBATCH_H
+
+#include <main.h>
+#include <worldsim.h>
+#include <rng.h>
+
+//
+//  Constants
+//
+#define WBATCH_LANES        8       // env count is padded to a multiple of this
+#define WBATCH_PIPES        3       // pipe pairs per env, same as resetWorld
+
+//
+//  Typedefs
+//
+
+// N independent games in struct-of-arrays form, physics matches stepWorld
+typedef struct worldbatch_s {
+    u32 count;
+    u32 capacity;
+    f32 dt;
+
+    f32* birdY;
+    f32* birdSpeed;
+    f32* scrollSpeed;
+    f32* speedupTimer;
+
+    f32* pipeX[WBATCH_PIPES];
+    f32* gapTop[WBATCH_PIPES];      // lower edge of top pipe
+    f32* gapBot[WBATCH_PIPES];      // upper edge of bottom pipe
+
+    // fixed 32 bit lanes, u32 is 64 bit on LP64 targets
+    Uint32* score;
+    Uint32* done;                   // set on crash, env is reset on next step
+
+    rnglanes_t rng;                 // one pipe generation stream per env
+
+    u64 steps;
+    void* mem;
+} worldbatch_t;
+
+//
+//  Public functions
+//
+worldbatch_t* wbatchCreate(u32 count, u32 tickRate, u64 seed);
+void wbatchDestroy(worldbatch_t* batch);
+void wbatchRestart(worldbatch_t* batch, u32 count, u64 seed);
+void wbatchReset(worldbatch_t* batch);
+void wbatchResetEnv(worldbatch_t* batch, u32 idx);
+
+u32  wbatchStep(worldbatch_t* batch, const u8* actions);
+
+const char* wbatchKernelName(void);
+
+#endif
\ No newline at end of file
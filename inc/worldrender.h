@@ -0,0 +1,50 @@
+#ifndef WORLDRENDER_H
+#define WORLDRENDER_H
+
+#include <main.h>
+#include <ascii.h>
+#include <worldsim.h>
+#include <worldsnap.h>
+
+extern world_t g_world;
+
+// ascii pipe parts of the current game, renderPipes draws cached columns composed from them
+extern asciiobj_t* g_wAsciiPipeHeadTop;
+extern asciiobj_t* g_wAsciiPipeHeadBot;
+extern asciiobj_t* g_wAsciiPipeSection;
+
+void inputUpdraft(void);
+
+void toggleHitboxes(void);
+void toggleAscii(void);
+void toggleGodMode(void);
+void setGodMode(bool enabled);
+
+void initWorld(void);
+void initWorldSeed(u64 seed);
+void requestReset(void);
+void setTickRate(u32 hz);
+u32  getTickRate(void);
+u64  getTotalTicks(void);
+
+// simulation side
+u32  simulateWorld(u64 dt);
+u32  fastForwardWorld(u64 target);
+bool applyReplayEvents(void);
+
+bool startSimThread(void);
+void stopSimThread(void);
+
+// render side
+u32  updateWorld(u64 dt);
+u32  renderSnapshot(u64 dt);
+u32  getWorldResult(void);
+void renderWorld(const worldsnap_t* snap, f32 alpha, u64 dt);
+
+void renderClouds(u64 dt);
+void renderPipes(const worldsnap_t* snap, f32 alpha);
+asciiobj_t* getPipeMesh(bool hanging, i32 sections);
+void renderBird(const sprite_t* bird, f32 alpha);
+void handleAnimation(u64 dt);
+
+#endif
\ No newline at end of file
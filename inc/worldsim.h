@@ -2,8 +2,10 @@
 #define WORLDSIM_H
 
 #include <main.h>
+#include <rng.h>
 
 #define WORLD_MAX_SPRITES   8
+#define WORLD_MAX_PIPES     4
 
 #define GAME_CONTINUE       0
 
@@ -21,12 +23,17 @@
 #define WORLD_STD_PIPE_WIDTH        (   80)
 #define WORLD_STD_SPEEDUP_INTERVAL  (  700)
 
+#define WORLD_STD_TICK_RATE         250     // physics ticks per second
+#define WORLD_MAX_CATCHUP_TICKS     25      // max ticks simulated per frame, excess time is dropped
+
 typedef struct sprite_s {
     u32 spriteType;
     u16 width;
     u16 height;
     f32 xpos;
     f32 ypos;
+    f32 prevx;      // position at start of last tick, used for render interpolation
+    f32 prevy;
 } sprite_t;
 
 typedef struct pipepair_s {
@@ -34,28 +41,42 @@ typedef struct pipepair_s {
     sprite_t* bot;
 } pipepair_t;
 
-sprite_t* addSprite(u32 type, u16 width, u16 height, f32 xpos, f32 ypos);
-pipepair_t* addPipePair(f32 xpos);
+// complete physics state of one game, pipe pairs point into sprites so worlds must not be copied
+typedef struct world_s {
+    sprite_t sprites[WORLD_MAX_SPRITES];
+    pipepair_t pipes[WORLD_MAX_PIPES];
+    u8 spriteIdx;
+    u8 pipesIdx;
 
-void moveSprite(sprite_t* sprite, f32 dx, f32 dy);
-void inputUpdraft(void);
+    bool updraft;
+    bool godMode;
+
+    f32 scrollSpeed;
+    f32 speedupTimer;
+    f32 birdSpeed;
 
-void toggleHitboxes(void);
-void toggleAscii(void);
-void toggleGodMode(void);
+    u32 score;
+    u64 ticks;
 
-void initWorld(void);
-u32  updateWorld(u64 dt);
+    rng_t rng;      // pipe generation, kept across resets
+} world_t;
 
-void renderClouds(u64 dt);
-void renderPipes(void);
-void renderBird(sprite_t* bird);
+//
+//  Physics, no rendering
+//
+void seedWorld(world_t* world, u64 seed);
+void resetWorld(world_t* world);
+u32  stepWorld(world_t* world, f32 dt);
+
+sprite_t* addSprite(world_t* world, u32 type, u16 width, u16 height, f32 xpos, f32 ypos);
+pipepair_t* addPipePair(world_t* world, f32 xpos);
+
+void moveSprite(sprite_t* sprite, f32 dx, f32 dy);
 
-sprite_t* getBird(void);
-void scrollScreen(f32 dx);
-void randomizePair(pipepair_t* pair, bool resetXPos);
-bool checkCollision(sprite_t* bird);
-void handleBirdVerticalSpeed(sprite_t* bird, u64 dt, bool updraft);
-void handleAnimation(u64 dt);
+sprite_t* getBird(world_t* world);
+void scrollScreen(world_t* world, f32 dx);
+void randomizePair(world_t* world, pipepair_t* pair, bool resetXPos);
+bool checkCollision(world_t* world, sprite_t* bird);
+void handleBirdVerticalSpeed(world_t* world, sprite_t* bird, f32 dt, bool updraft);
 
 #endif
\ No newline at end of file
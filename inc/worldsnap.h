@@ -0,0 +1,58 @@
+#ifndef WORLDSNAP_H
+#define WORLDSNAP_H
+
+#include <main.h>
+#include <worldsim.h>
+
+//
+//  Constants
+//
+#define SNAP_SLOTS          3
+#define SNAP_SLOT_MASK      0x3
+#define SNAP_FRESH          0x4     // shared slot was published and not taken by the consumer yet
+
+//
+//  Typedefs
+//
+
+// copy of everything the render stage reads from the simulation, never changed once published
+typedef struct worldsnap_s {
+    sprite_t sprites[WORLD_MAX_SPRITES];    // current and previous tick positions, for interpolation
+    u8  spriteIdx;
+
+    u32 score;
+    u32 result;         // GAME_CONTINUE, final score once the game is over
+
+    u64 ticks;          // of the current game
+    u64 totalTicks;
+    u64 tickNS;
+
+    f32 alpha;          // time left in accumulator at publish, in ticks
+    u64 publishNS;      // SDL_GetTicksNS at publish, render extrapolates alpha from here
+
+    u64 resets;         // games started, render side ascii objects are rebuilt when it changes
+    u64 updrafts;       // updrafts applied, flap animation starts when it changes
+    u32 requests;       // reset requests taken, snapshots with fewer show the game before the reset
+
+    u64 seq;            // publish count, 0 if nothing was published yet
+} worldsnap_t;
+
+// lock-free triple buffer, one producer and one consumer, neither ever waits for the other
+typedef struct snapbuf_s {
+    worldsnap_t slots[SNAP_SLOTS];
+    SDL_AtomicInt shared;   // slot index handed between the two, | SNAP_FRESH when newly published
+    u32 back;               // producer only, slot being written
+    u32 front;              // consumer only, slot being read
+} snapbuf_t;
+
+//
+//  Public functions
+//
+void snapInit(snapbuf_t* buf);
+
+worldsnap_t* snapBackSlot(snapbuf_t* buf);
+void snapPublish(snapbuf_t* buf);
+
+const worldsnap_t* snapLatest(snapbuf_t* buf);
+
+#endif
@@ -4,11 +4,30 @@
 #include <string.h>
 #include <SDL3/SDL.h>
 
+#if defined _MSC_VER && !defined __clang__
+    #include <intrin.h>
+#endif
+
+#if defined __SSE2__
+    #include <emmintrin.h>
+#endif
+
 #include <ascii.h>
+#include <ascii3d.h>
+#include <asciiplace.h>
 #include <render.h>
+#include <profiler.h>
 #include <debug/rdebug.h>
 #include <debug/memtrack.h>
 
+// copy kernels and render queue assume these, u32 fields used to make them 24 and 40 bytes on LP64
+SDL_COMPILE_TIME_ASSERT(ascii2_size, sizeof(ascii2_t) == 8);
+SDL_COMPILE_TIME_ASSERT(ascii3_size, sizeof(ascii3_t) == 16);
+
+Uint32 g_asciiPalette[ASCII_PALETTE_SIZE];
+u32 g_asciiPaletteLen = 0;
+u32 g_asciiPaletteLast = 0;
+
 char g_asciiRenderBufMem[ASCII_RENDER_BUF_SIZE];
 char g_asciiCharBufMem[ASCII_CHAR_BUF_SIZE];
 
@@ -18,8 +37,16 @@ void* g_charbuf = (void*) g_asciiCharBufMem;
 u32 g_renderBufIdx = 0;
 u32 g_charBufIdx = 0;
 
-asciiobj_t g_asciiObjBuf[ASCII_OBJ_BUF_SIZE];
-asciiobj_t* g_objidx = g_asciiObjBuf;
+// render queue, grows by linking chunks, queued glyphs never move
+renderchunk_t g_renderQueue = {g_asciiRenderBufMem, ASCII_RENDER_BUF_SIZE, 0, NULL};
+renderchunk_t* g_renderTail = &g_renderQueue;
+
+asciiqueuestats_t g_renderQueueStats = {0, 1, ASCII_RENDER_BUF_SIZE, 0, 0};
+
+// objects, page records and glyph arrays of pages come from pools, created on first use
+mpool_t* g_asciiObjPool = NULL;
+mpool_t* g_asciiPagePool = NULL;
+mpool_t* g_asciiGlyphPools[ASCII_PAGE_CLASSES];
 
 u32 g_asciistate = ASCII_RENDER_UNINIT;
 
@@ -28,6 +55,239 @@ u16 g_objMemFragmented = 0;
 
 pageinfo_t* g_pagedmem = NULL;
 
+// char buf occupancy, one bit per glyph slot, slots past the end of the buf are marked used
+Uint64 g_charMap[ASCII_CHAR_MAP_WORDS];
+
+//
+//  Local functions
+//
+static inline u32 lowestBit(Uint64 x)
+{
+#if defined _MSC_VER && !defined __clang__
+    unsigned long idx;
+
+    _BitScanForward64(&idx, x);
+
+    return idx;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// mark slots [first, first + len) in char buf map as used or free
+static void setCharSlots(u32 first, u32 len, bool used)
+{
+    while (len) {
+        u32 off = first % 64;
+        u32 n = SDL_min(len, 64 - off);
+        Uint64 mask = (n == 64 ? ~(Uint64) 0 : (((Uint64) 1 << n) - 1)) << off;
+
+        if (used)
+            g_charMap[first / 64] |= mask;
+        else
+            g_charMap[first / 64] &= ~mask;
+
+        first += n;
+        len -= n;
+    }
+}
+
+// first fit over char buf map, skips whole runs of used or free slots at once, -1 if no run of len slots is free
+static i32 allocCharSlots(u32 len)
+{
+    u32 slots = ASCII_CHAR_MAP_WORDS * 64;
+    u32 run = 0;
+    u32 start = 0;
+
+    for (u32 pos = 0; pos < slots;) {
+        u32 off = pos % 64;
+        Uint64 used = g_charMap[pos / 64] >> off;
+
+        if (used & 1) {
+            pos += ~used ? lowestBit(~used) : 64;
+            run = 0;
+
+            continue;
+        }
+
+        if (!run)
+            start = pos;
+
+        u32 n = used ? lowestBit(used) : 64 - off;
+
+        run += n;
+        pos += n;
+
+        if (run >= len) {
+            setCharSlots(start, len, 1);
+            return start;
+        }
+    }
+
+    return -1;
+}
+
+static void freeCharSlots(u32 first, u32 len)
+{
+    rAssert(first + len <= ASCII_CHAR_MAP_WORDS * 64);
+
+    setCharSlots(first, len, 0);
+}
+
+// contiguous space for len glyphs of size bytes at end of render queue, links next chunk if tail is full
+static void* reserveRenderQueue(u32 len, u32 size)
+{
+    renderchunk_t* chunk = g_renderTail;
+    u32 bytes = len * size;
+
+    if (chunk->used + bytes > chunk->size) {
+        // chunks of earlier frames are reused, a new one is linked in if the next one is too small
+        if (!chunk->next || chunk->next->size < bytes) {
+            u32 chunkSize = SDL_max(ASCII_RENDER_CHUNK_SIZE, bytes);
+            renderchunk_t* tmp = (renderchunk_t*) memAlloc(sizeof(renderchunk_t) + chunkSize);
+
+            if (!tmp)
+                return NULL;
+
+            tmp->mem = tmp + 1;
+            tmp->size = chunkSize;
+            tmp->used = 0;
+            tmp->next = chunk->next;
+
+            chunk->next = tmp;
+
+            g_renderQueueStats.chunks++;
+            g_renderQueueStats.capacity += chunkSize;
+        }
+
+        chunk = chunk->next;
+        g_renderTail = chunk;
+
+        g_renderQueueStats.spills++;
+        profCount(PROF_COUNTER_QUEUE_SPILLS, 1);
+    }
+
+    void* ptr = (char*) chunk->mem + chunk->used;
+
+    chunk->used += bytes;
+    g_renderBufIdx += len;
+
+    if (g_renderBufIdx > g_renderQueueStats.peakChars)
+        g_renderQueueStats.peakChars = g_renderBufIdx;
+
+    g_renderQueueStats.bytesCopied += bytes;
+
+    profCount(PROF_COUNTER_QUEUE_CHARS, len);
+    profCount(PROF_COUNTER_QUEUE_BYTES, bytes);
+
+    return ptr;
+}
+
+static void clearRenderQueue(void)
+{
+    for (renderchunk_t* i = &g_renderQueue; i; i = i->next)
+        i->used = 0;
+
+    g_renderTail = &g_renderQueue;
+    g_renderBufIdx = 0;
+}
+
+static void freeRenderQueue(void)
+{
+    renderchunk_t* next;
+
+    for (renderchunk_t* i = g_renderQueue.next; i; i = next) {
+        next = i->next;
+        memFree(i);
+    }
+
+    g_renderQueue.next = NULL;
+
+    clearRenderQueue();
+
+    memset(&g_renderQueueStats, 0, sizeof(g_renderQueueStats));
+
+    g_renderQueueStats.chunks = 1;
+    g_renderQueueStats.capacity = ASCII_RENDER_BUF_SIZE;
+}
+
+// saturating, glyphs far off screen stay far off screen instead of wrapping around
+static inline Sint16 addFixed(Sint16 a, Sint16 b)
+{
+    i32 sum = (i32) a + (i32) b;
+
+    return (Sint16) SDL_max(-32768, SDL_min(sum, 32767));
+}
+
+#if defined __SSE2__
+
+#define ASCII_KERNEL_NAME   "sse2"
+
+// two glyphs per register, offset lanes for color, id and flags are zero so they pass through unchanged
+static void copyOffset2D(ascii2_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    Sint16 fx = asciiPosToFixed(dx);
+    Sint16 fy = asciiPosToFixed(dy);
+
+    const __m128i offset = _mm_setr_epi16(fx, fy, 0, 0, fx, fy, 0, 0);
+
+    u32 i = 0;
+
+    for (; i + 2 <= len; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (src + i));
+
+        _mm_storeu_si128((__m128i*) (dst + i), _mm_adds_epi16(v, offset));
+    }
+
+    if (i < len) {
+        dst[i] = src[i];
+        dst[i].xpos = addFixed(src[i].xpos, fx);
+        dst[i].ypos = addFixed(src[i].ypos, fy);
+    }
+}
+
+// one glyph per register, lane with color, id and flags is masked off so its bits never pass through a float add
+static void copyOffset3D(ascii3_t* dst, const ascii3_t* src, u32 len, f32 dx, f32 dy, f32 dz)
+{
+    const __m128 offset = _mm_setr_ps(dx, dy, dz, 0.0f);
+    const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+    for (u32 i = 0; i < len; i++) {
+        __m128 v = _mm_loadu_ps((const float*) (src + i));
+        __m128 t = _mm_add_ps(v, offset);
+
+        _mm_storeu_ps((float*) (dst + i), _mm_or_ps(_mm_andnot_ps(mask, v), _mm_and_ps(mask, t)));
+    }
+}
+
+#else
+
+#define ASCII_KERNEL_NAME   "scalar"
+
+static void copyOffset2D(ascii2_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    Sint16 fx = asciiPosToFixed(dx);
+    Sint16 fy = asciiPosToFixed(dy);
+
+    for (u32 i = 0; i < len; i++) {
+        dst[i] = src[i];
+        dst[i].xpos = addFixed(src[i].xpos, fx);
+        dst[i].ypos = addFixed(src[i].ypos, fy);
+    }
+}
+
+static void copyOffset3D(ascii3_t* dst, const ascii3_t* src, u32 len, f32 dx, f32 dy, f32 dz)
+{
+    for (u32 i = 0; i < len; i++) {
+        dst[i] = src[i];
+        dst[i].xpos += dx;
+        dst[i].ypos += dy;
+        dst[i].zpos += dz;
+    }
+}
+
+#endif
+
 // initialize ascii renderer
 void initAscii(u32 renderMode)
 {
@@ -37,13 +297,36 @@ void initAscii(u32 renderMode)
 
     memset(g_renderbuf, 0, ASCII_RENDER_BUF_SIZE);
     memset(g_charbuf, 0, ASCII_CHAR_BUF_SIZE);
-    memset(g_asciiObjBuf, 0, sizeof(g_asciiObjBuf));
+    memset(g_charMap, 0, sizeof(g_charMap));
+
+    clearRenderQueue();
+
+    // 3D glyphs are bigger, fewer slots fit
+    u32 slots = ASCII_CHAR_BUF_SIZE / (renderMode == ASCII_RENDER_MODE_2D ? sizeof(ascii2_t) : sizeof(ascii3_t));
+
+    setCharSlots(slots, ASCII_CHAR_MAP_WORDS * 64 - slots, 1);
+
+    if (!g_asciiObjPool)
+        g_asciiObjPool = memPoolCreateType(asciiobj_t, ASCII_OBJ_BUF_SIZE);
+    else
+        memPoolReset(g_asciiObjPool);
+
+    if (!g_asciiPagePool)
+        g_asciiPagePool = memPoolCreateType(pageinfo_t, ASCII_OBJ_BUF_SIZE);
+    else
+        memPoolReset(g_asciiPagePool);
+
+    for (u32 i = 0; i < ASCII_PAGE_CLASSES; i++) {
+        if (g_asciiGlyphPools[i])
+            memPoolReset(g_asciiGlyphPools[i]);
+    }
+
+    if (!g_asciiObjPool || !g_asciiPagePool)
+        SDL_Log("Failed to allocate ASCII object pools");
 
     g_asciistate = renderMode;
-    g_objidx = g_asciiObjBuf;
     g_charMemFragmented = 0;
     g_objMemFragmented = 0;
-    g_renderBufIdx = 0;
     g_charBufIdx = 0;
     g_pagedmem = NULL;
 }
@@ -52,6 +335,21 @@ void initAscii(u32 renderMode)
 void cleanupAscii(void)
 {
     asciiResetAll();
+
+    memPoolDestroy(g_asciiObjPool);
+    memPoolDestroy(g_asciiPagePool);
+
+    g_asciiObjPool = NULL;
+    g_asciiPagePool = NULL;
+
+    for (u32 i = 0; i < ASCII_PAGE_CLASSES; i++) {
+        memPoolDestroy(g_asciiGlyphPools[i]);
+        g_asciiGlyphPools[i] = NULL;
+    }
+
+    freeRenderQueue();
+    ascii3DCleanup();
+
     g_asciistate = ASCII_RENDER_UNINIT;
 }
 
@@ -87,6 +385,9 @@ void asciiChangeMode(u32 renderMode)
         return;
     }
 
+    if (g_pagedmem)
+        freePages();
+
     initAscii(renderMode);
 }
 
@@ -109,10 +410,11 @@ void asciiRender2D(u32 backgroundColor, u16 clearScr, u16 preserveRenderBuf)
     if (clearScr)
         clearScreen(backgroundColor);
 
-    renderBuf2D((ascii2_t*) g_renderbuf, g_renderBufIdx, 0.0f, 0.0f);
+    for (renderchunk_t* i = &g_renderQueue; i != g_renderTail->next; i = i->next)
+        renderBuf2D((ascii2_t*) i->mem, i->used / sizeof(ascii2_t), 0.0f, 0.0f);
 
     if (!preserveRenderBuf)
-        g_renderBufIdx = 0;
+        clearRenderQueue();
 }
 
 // render ascii buf
@@ -123,10 +425,16 @@ void asciiRender3D(u32 backgroundColor, u16 clearScr, u16 preserveRenderBuf)
     if (clearScr)
         clearScreen(backgroundColor);
 
-    renderBuf3D((ascii3_t*) g_renderbuf, g_renderBufIdx, 0.0f, 0.0f, 0.0f);
+    // whole queue is one batch so glyphs of all chunks are depth sorted together
+    ascii3DBegin();
+
+    for (renderchunk_t* i = &g_renderQueue; i != g_renderTail->next; i = i->next)
+        ascii3DSubmit((ascii3_t*) i->mem, i->used / sizeof(ascii3_t), 0.0f, 0.0f, 0.0f);
+
+    ascii3DFlush();
 
     if (!preserveRenderBuf)
-        g_renderBufIdx = 0;
+        clearRenderQueue();
 }
 
 // write 2D object to render buf
@@ -137,23 +445,27 @@ void renderAsciiObject2D(asciiobj_t* object)
     rAssert(object->type == ASCII_OBJ_2D);
     rAssert(g_asciistate == ASCII_RENDER_MODE_2D);
 
-    if (g_renderBufIdx + object->len >= ASCII_MAX_2D_CHARS) {
-        SDL_Log("Failed to render 2D ASCII object, render buf full");
+    if (!asciiObjectOnScreen2D(object)) {
+        profCount(PROF_COUNTER_CULLED_OBJECTS, 1);
         return;
     }
 
-    memcpy((ascii2_t*) g_renderbuf + g_renderBufIdx, object->data.ascii2, object->len * sizeof(ascii2_t));
+    ascii2_t* dst = (ascii2_t*) reserveRenderQueue(object->len, sizeof(ascii2_t));
+
+    if (!dst) {
+        SDL_Log("Failed to render 2D ASCII object, render queue chunk allocation failed");
+        return;
+    }
 
     if (object->xpos > EPSILON || object->xpos < -EPSILON ||
         object->ypos > EPSILON || object->ypos < -EPSILON)
     {
-        for (u32 i = 0; i < object->len; i++) {
-            ((ascii2_t*) g_renderbuf + i)->xpos += object->xpos;
-            ((ascii2_t*) g_renderbuf + i)->ypos += object->ypos;
-        }
+        copyOffset2D(dst, object->data.ascii2, object->len, object->xpos, object->ypos);
+    }
+    else
+    {
+        memcpy(dst, object->data.ascii2, object->len * sizeof(ascii2_t));
     }
-
-    g_renderBufIdx += object->len;
 }
 
 // write 3D object to render buf
@@ -164,25 +476,58 @@ void renderAsciiObject3D(asciiobj_t* object)
     rAssert(object->type == ASCII_OBJ_3D);
     rAssert(g_asciistate == ASCII_RENDER_MODE_3D);
 
-    if (g_renderBufIdx + object->len >= ASCII_MAX_3D_CHARS) {
-        SDL_Log("Failed to render 3D ASCII object, render buf full");
+    ascii3_t* dst = (ascii3_t*) reserveRenderQueue(object->len, sizeof(ascii3_t));
+
+    if (!dst) {
+        SDL_Log("Failed to render 3D ASCII object, render queue chunk allocation failed");
         return;
     }
 
-    memcpy((ascii3_t*) g_renderbuf + g_renderBufIdx, object->data.ascii3, object->len * sizeof(ascii3_t));
-
     if (object->xpos > EPSILON || object->xpos < -EPSILON ||
         object->ypos > EPSILON || object->ypos < -EPSILON ||
         object->zpos > EPSILON || object->zpos < -EPSILON )
     {
-        for (u32 i = 0; i < object->len; i++) {
-            ((ascii3_t*) g_renderbuf + i)->xpos += object->xpos;
-            ((ascii3_t*) g_renderbuf + i)->ypos += object->ypos;
-            ((ascii3_t*) g_renderbuf + i)->zpos += object->zpos;
-        }
+        copyOffset3D(dst, object->data.ascii3, object->len, object->xpos, object->ypos, object->zpos);
     }
+    else
+    {
+        memcpy(dst, object->data.ascii3, object->len * sizeof(ascii3_t));
+    }
+}
+
+void asciiGetQueueStats(asciiqueuestats_t* stats)
+{
+    rAssert(stats);
+
+    *stats = g_renderQueueStats;
+}
+
+// first chunk of render queue, chunks up to the one in use hold queued glyphs
+const renderchunk_t* asciiGetRenderQueue(void)
+{
+    return &g_renderQueue;
+}
+
+// copy glyphs and translate their positions in one pass, dst and src must not overlap
+void asciiCopyOffset2D(ascii2_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    rAssert(dst);
+    rAssert(src);
+
+    copyOffset2D(dst, src, len, dx, dy);
+}
+
+void asciiCopyOffset3D(ascii3_t* dst, const ascii3_t* src, u32 len, f32 dx, f32 dy, f32 dz)
+{
+    rAssert(dst);
+    rAssert(src);
 
-    g_renderBufIdx += object->len;
+    copyOffset3D(dst, src, len, dx, dy, dz);
+}
+
+const char* asciiCopyKernelName(void)
+{
+    return ASCII_KERNEL_NAME;
 }
 
 // bypass render buf, render 2D object directly
@@ -193,6 +538,11 @@ void renderAsciiObjectDirect2D(asciiobj_t* object)
     rAssert(object->type == ASCII_OBJ_2D);
     rAssert(g_asciistate == ASCII_RENDER_MODE_2D);
 
+    if (!asciiObjectOnScreen2D(object)) {
+        profCount(PROF_COUNTER_CULLED_OBJECTS, 1);
+        return;
+    }
+
     renderBuf2D(object->data.ascii2, object->len, object->xpos, object->ypos);
 }
 
@@ -224,19 +574,18 @@ asciiobj_t* asciiObject2D(const vec2f_t* positions, const u32* colors, const u32
     for (u32 i = 0; i < len; i++) {
         chr = object->data.ascii2 + i;
 
-        chr->xpos = positions[i].x;
-        chr->ypos = positions[i].y;
-        chr->charID = chars[i];
-        chr->visible = 1;
-
-        rAssert(chr->charID > 31);
+        rAssert(chars[i] > 31 && chars[i] < 127);
 
-        if (colors)
-            chr->color = colors[i];
-        else
-            chr->color = COLOR_WHITE;
+        chr->xpos = asciiPosToFixed(positions[i].x);
+        chr->ypos = asciiPosToFixed(positions[i].y);
+        chr->color = asciiPaletteIndex(colors ? colors[i] : COLOR_WHITE);
+        chr->charID = (Uint8) chars[i];
+        chr->flags = ASCII_GLYPH_VISIBLE;
+        chr->pad = 0;
     }
 
+    asciiUpdateBounds2D(object);
+
     return object;
 }
 
@@ -257,18 +606,15 @@ asciiobj_t* asciiObject3D(const vec3f_t* positions, const u32* colors, const u32
     for (u32 i = 0; i < len; i++) {
         chr = object->data.ascii3 + i;
 
+        rAssert(chars[i] > 31 && chars[i] < 127);
+
         chr->xpos = positions[i].x;
         chr->ypos = positions[i].y;
         chr->zpos = positions[i].z;
-        chr->charID = chars[i];
-        chr->visible = 1;
-
-        rAssert(chr->charID > 31);
-
-        if (colors)
-            chr->color = colors[i];
-        else
-            chr->color = COLOR_WHITE;
+        chr->color = asciiPaletteIndex(colors ? colors[i] : COLOR_WHITE);
+        chr->charID = (Uint8) chars[i];
+        chr->flags = ASCII_GLYPH_VISIBLE;
+        chr->pad = 0;
     }
 
     return object;
@@ -290,18 +636,104 @@ asciiobj_t* asciiObject2DIStruct(const ascii2info_t* info, u64 len)
     for (u32 i = 0; i < len; i++) {
         chr = object->data.ascii2 + i;
 
-        chr->xpos = info[i].pos.x;
-        chr->ypos = info[i].pos.y;
-        chr->color = info[i].color;
-        chr->charID = info[i].charID;
-        chr->visible = 1;
+        rAssert(info[i].charID > 31 && info[i].charID < 127);
 
-        rAssert(chr->charID > 31);
+        chr->xpos = asciiPosToFixed(info[i].pos.x);
+        chr->ypos = asciiPosToFixed(info[i].pos.y);
+        chr->color = asciiPaletteIndex(info[i].color);
+        chr->charID = (Uint8) info[i].charID;
+        chr->flags = ASCII_GLYPH_VISIBLE;
+        chr->pad = 0;
     }
 
+    asciiUpdateBounds2D(object);
+
     return object;
 }
 
+// palette index of color, added if new, nearest entry once all are taken
+Uint8 asciiPaletteIndex(u32 color)
+{
+    Uint32 c = (Uint32) color;
+
+    if (g_asciiPaletteLast < g_asciiPaletteLen && g_asciiPalette[g_asciiPaletteLast] == c)
+        return (Uint8) g_asciiPaletteLast;
+
+    for (u32 i = 0; i < g_asciiPaletteLen; i++) {
+        if (g_asciiPalette[i] == c) {
+            g_asciiPaletteLast = i;
+            return (Uint8) i;
+        }
+    }
+
+    if (g_asciiPaletteLen < ASCII_PALETTE_SIZE) {
+        g_asciiPalette[g_asciiPaletteLen] = c;
+        g_asciiPaletteLast = g_asciiPaletteLen;
+        return (Uint8) g_asciiPaletteLen++;
+    }
+
+    u32 best = 0;
+    u32 bestDist = 0xffffffff;
+
+    for (u32 i = 0; i < ASCII_PALETTE_SIZE; i++) {
+        u32 dist = 0;
+
+        for (u32 shift = 0; shift < 32; shift += 8) {
+            i32 d = (i32) ((g_asciiPalette[i] >> shift) & 0xff) - (i32) ((c >> shift) & 0xff);
+            dist += d * d;
+        }
+
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = i;
+        }
+    }
+
+    return (Uint8) best;
+}
+
+// local bounding box of 2D object glyphs, call again after moving glyphs of the object
+void asciiUpdateBounds2D(asciiobj_t* object)
+{
+    rAssert(object);
+    rAssert(object->type == ASCII_OBJ_2D);
+
+    if (!object->len) {
+        object->bmin.x = object->bmin.y = 0.0f;
+        object->bmax.x = object->bmax.y = 0.0f;
+        return;
+    }
+
+    const ascii2_t* chr = object->data.ascii2;
+
+    Sint16 minx = chr->xpos, miny = chr->ypos;
+    Sint16 maxx = minx, maxy = miny;
+
+    for (u32 i = 1; i < object->len; i++) {
+        minx = SDL_min(minx, chr[i].xpos);
+        miny = SDL_min(miny, chr[i].ypos);
+        maxx = SDL_max(maxx, chr[i].xpos);
+        maxy = SDL_max(maxy, chr[i].ypos);
+    }
+
+    object->bmin.x = asciiPosFromFixed(minx);
+    object->bmin.y = asciiPosFromFixed(miny);
+    object->bmax.x = asciiPosFromFixed(maxx) + ASCII_GLYPH_EXTENT;
+    object->bmax.y = asciiPosFromFixed(maxy) + ASCII_GLYPH_EXTENT;
+}
+
+// bounding box at current object offset overlaps the viewport
+bool asciiObjectOnScreen2D(const asciiobj_t* object)
+{
+    rAssert(object);
+
+    if (!object->len)
+        return 0;
+
+    return object->xpos + object->bmax.x >= -1.0f && object->xpos + object->bmin.x <= WINDOW_WIDTH &&
+           object->ypos + object->bmax.y >= -1.0f && object->ypos + object->bmin.y <= WINDOW_HEIGHT;
+}
+
 // create 3D ascii object
 asciiobj_t* asciiObject3DIStruct(const ascii3info_t* info, u64 len)
 {
@@ -318,14 +750,15 @@ asciiobj_t* asciiObject3DIStruct(const ascii3info_t* info, u64 len)
     for (u32 i = 0; i < len; i++) {
         chr = object->data.ascii3 + i;
 
+        rAssert(info[i].charID > 31 && info[i].charID < 127);
+
         chr->xpos = info[i].pos.x;
         chr->ypos = info[i].pos.y;
         chr->zpos = info[i].pos.z;
-        chr->color = info[i].color;
-        chr->charID = info[i].charID;
-        chr->visible = 1;
-
-        rAssert(chr->charID > 31);
+        chr->color = asciiPaletteIndex(info[i].color);
+        chr->charID = (Uint8) info[i].charID;
+        chr->flags = ASCII_GLYPH_VISIBLE;
+        chr->pad = 0;
     }
 
     return object;
@@ -335,205 +768,213 @@ asciiobj_t* asciiObject3DIStruct(const ascii3info_t* info, u64 len)
 void renderBuf2D(const ascii2_t* buf, u64 len, f32 dx, f32 dy)
 {
     rAssert(buf);
-    
-    for (u32 i = 0; i < len; i++) {
-        if (!buf[i].visible || buf[i].charID < 32)
-            continue;
 
-        renderCharColor
-        (
-            (i16) roundf(buf[i].xpos + dx),
-            (i16) roundf(buf[i].ypos + dy),
-            ASCII_RENDER_SCALE,
-            buf[i].color,
-            buf[i].charID
-        );
+    profBegin(PROF_ZONE_BUF2D);
+
+    // placed in batches so rects stay in cache between kernel and glyph batch
+    asciiplaced_t placed[ASCII_PLACE_BATCH];
+
+    for (u64 first = 0; first < len; first += ASCII_PLACE_BATCH) {
+        u32 count = asciiPlace2D(placed, buf + first, (u32) SDL_min(len - first, ASCII_PLACE_BATCH), dx, dy);
+
+        for (u32 i = 0; i < count; i++)
+            renderCharRect(&placed[i].dst, placed[i].color, (char) placed[i].charID);
     }
+
+    profEnd(PROF_ZONE_BUF2D);
 }
 
-// render 3D char buf to screen
+// render 3D char buf to screen through the camera, depth sorted within buf
 void renderBuf3D(const ascii3_t* buf, u32 len, f32 dx, f32 dy, f32 dz)
 {
     rAssert(buf);
 
-    for (u32 i = 0; i < len; i++) {
-        if (!buf[i].visible || buf[i].charID < 32)
-            continue;
-
-        renderCharColor
-        (
-            (i16) roundf(buf[i].xpos + dx),
-            (i16) roundf(buf[i].ypos + dy),
-            ASCII_RENDER_SCALE,
-            buf[i].color,
-            buf[i].charID
-        );
-    }
+    ascii3DBegin();
+    ascii3DSubmit(buf, len, dx, dy, dz);
+    ascii3DFlush();
 }
  
-// init ascii object in object buf
-asciiobj_t* getAsciiObj(u32 type, u32 len)
+// smallest glyph pool class that fits size bytes, ASCII_PAGE_CLASSES if none does
+static u32 pageClass(u32 size)
 {
-    rAssert(len);
-    rAssert(type == ASCII_OBJ_2D || type == ASCII_OBJ_3D);
+    u32 cls = 0;
 
-    if (g_objidx >= g_asciiObjBuf + ASCII_OBJ_BUF_SIZE) {
-        SDL_Log("Failed to add ASCII object, object buffer full");
-        return NULL;
-    }
+    for (u32 classSize = ASCII_PAGE_MIN_SIZE; cls < ASCII_PAGE_CLASSES && classSize < size; classSize *= 4)
+        cls++;
 
-    g_objidx->type = type;
-    g_objidx->len = len;
-    g_objidx->visible = 1;
+    return cls;
+}
 
-    g_objidx->xpos = 0.0f;
-    g_objidx->ypos = 0.0f;
-    g_objidx->zpos = 0.0f;
+static void* allocPageGlyphs(u32 size)
+{
+    u32 cls = pageClass(size);
 
-    g_objidx->paged = getAsciiObjMem((void**) &g_objidx->data, type, len);
+    // bigger than any class, rare enough to go to the heap
+    if (cls == ASCII_PAGE_CLASSES) {
+        void* ptr = memAlloc(size);
+        return ptr;
+    }
 
-    return g_objidx++;
-}
+    if (!g_asciiGlyphPools[cls])
+        g_asciiGlyphPools[cls] = memPoolCreate(ASCII_PAGE_MIN_SIZE << (2 * cls), ASCII_PAGE_COUNT);
 
-// find memory for ascii object
-bool getAsciiObjMem(void** dst, u32 type, u32 len)
-{ 
-    u32 count = 0;
+    void* ptr = g_asciiGlyphPools[cls] ? memPoolAlloc(g_asciiGlyphPools[cls]) : NULL;
 
-    if (type == ASCII_OBJ_2D)
-    {
-        rAssert(g_asciistate == ASCII_RENDER_MODE_2D);
+    if (!ptr)
+        SDL_Log("Failed to allocate ASCII memory page, page pool full");
 
-        for (u32 i = 0; i < ASCII_CHAR_BUF_SIZE; i++) {
-            if (!((ascii2_t*) g_charbuf + i)->charID)
-                count++;
-            else
-                count = 0;
+    return ptr;
+}
 
-            if (count >= len) {
-                *(ascii2_t**) dst = (ascii2_t*) g_charbuf + i + 1 - len;
+static void freePageGlyphs(void* ptr, u32 size)
+{
+    u32 cls = pageClass(size);
 
-                g_charBufIdx += len;
+    if (cls == ASCII_PAGE_CLASSES)
+        memFree(ptr);
+    else
+        memPoolFree(g_asciiGlyphPools[cls], ptr);
+}
 
-                return 0;
-            }
-        }
+// init ascii object in object buf
+asciiobj_t* getAsciiObj(u32 type, u32 len)
+{
+    rAssert(len);
+    rAssert(type == ASCII_OBJ_2D || type == ASCII_OBJ_3D);
 
-        ascii2_t* ptr = (ascii2_t*) memAlloc(len * sizeof(ascii2_t));
+    asciiobj_t* object = g_asciiObjPool ? (asciiobj_t*) memPoolAlloc(g_asciiObjPool) : NULL;
 
-        memPage(ptr, ASCII_OBJ_2D, len);
+    if (!object) {
+        SDL_Log("Failed to add ASCII object, object buffer full");
+        return NULL;
+    }
 
-        *(ascii2_t**) dst = ptr;
+    object->type = type;
+    object->len = len;
+    object->visible = 1;
 
-        return 1;
-    }
-    else
-    {
-        rAssert(g_asciistate == ASCII_RENDER_MODE_3D);
+    object->xpos = 0.0f;
+    object->ypos = 0.0f;
+    object->zpos = 0.0f;
 
-        for (u32 i = 0; i < ASCII_CHAR_BUF_SIZE; i++) {
-            if (!((ascii3_t*) g_charbuf + i)->charID)
-                count++;
-            else
-                count = 0;
+    object->bmin.x = object->bmin.y = 0.0f;
+    object->bmax.x = object->bmax.y = 0.0f;
 
-            if (count >= len) {
-                *(ascii3_t**) dst = (ascii3_t*) g_charbuf + i + 1 - len;
+    object->page = getAsciiObjMem((void**) &object->data, type, len);
+    object->paged = object->page != NULL;
 
-                g_charBufIdx += len;
+    if (!object->data.ascii2) {
+        memPoolFree(g_asciiObjPool, object);
+        return NULL;
+    }
 
-                return 0;
-            }
-        }
+    return object;
+}
 
-        ascii3_t* ptr = (ascii3_t*) memAlloc(len * sizeof(ascii3_t));
+// release object and its chars
+void removeAsciiObject(asciiobj_t* object)
+{
+    rAssert(object);
+    rAssert(g_asciiObjPool);
 
-        memPage(ptr, ASCII_OBJ_3D, len);
+    if (object->page) {
+        removeMemPage(object->page);
+    } else {
+        u32 size = object->type == ASCII_OBJ_2D ? sizeof(ascii2_t) : sizeof(ascii3_t);
 
-        *(ascii3_t**) dst = ptr;
+        freeCharSlots(((char*) object->data.ascii2 - (char*) g_charbuf) / size, object->len);
 
-        return 1;
+        g_charBufIdx -= object->len;
     }
+
+    memPoolFree(g_asciiObjPool, object);
 }
 
-// add memory page
-void memPage(void* ptr, u32 type, u32 len)
+// find memory for ascii object, return page record if it did not fit the char buf
+pageinfo_t* getAsciiObjMem(void** dst, u32 type, u32 len)
 {
-    if (!g_pagedmem)
-        g_pagedmem = (pageinfo_t*) memAlloc(sizeof(pageinfo_t));
+    rAssert(type == ASCII_OBJ_2D || type == ASCII_OBJ_3D);
+    rAssert(g_asciistate == type);
 
-    pageinfo_t* tmp = g_pagedmem;
+    u32 size = type == ASCII_OBJ_2D ? sizeof(ascii2_t) : sizeof(ascii3_t);
+    i32 slot = allocCharSlots(len);
 
-    rAssert(tmp);
+    if (slot >= 0) {
+        *dst = (char*) g_charbuf + slot * size;
 
-    while (tmp->next)
-        tmp = tmp->next;
+        g_charBufIdx += len;
 
-    tmp->next = (pageinfo_t*) memAlloc(sizeof(pageinfo_t));
+        return NULL;
+    }
 
-    rAssert(tmp->next);
+    void* ptr = allocPageGlyphs(len * size);
+    pageinfo_t* page = ptr ? memPage(ptr, type, len) : NULL;
 
-    tmp->next->ptr = ptr;
-    tmp->next->len = len;
-    tmp->next->type = type;
-    tmp->next->next = NULL;
+    *dst = page ? ptr : NULL;
 
-    SDL_Log("ASCII: added memory page");
+    return page;
 }
 
-// remove memory page
-void removeMemPage(void* ptr)
+// add memory page record, pages are pushed to the front of the list
+pageinfo_t* memPage(void* ptr, u32 type, u32 len)
 {
     rAssert(ptr);
-    rAssert(g_pagedmem);
 
-    pageinfo_t* tmp;
+    pageinfo_t* page = g_asciiPagePool ? (pageinfo_t*) memPoolAlloc(g_asciiPagePool) : NULL;
 
-    if (g_pagedmem->ptr == ptr) {
-        tmp = g_pagedmem->next;
+    if (!page) {
+        SDL_Log("Failed to add ASCII memory page, page buffer full");
 
-        memFree(g_pagedmem->ptr);
-        memFree(g_pagedmem);
+        freePageGlyphs(ptr, len * (type == ASCII_OBJ_2D ? sizeof(ascii2_t) : sizeof(ascii3_t)));
 
-        g_pagedmem = tmp;
+        return NULL;
+    }
 
-        SDL_Log("ASCII: removed memory page");
+    page->ptr = ptr;
+    page->len = len;
+    page->type = type;
+    page->prev = NULL;
+    page->next = g_pagedmem;
 
-        return;
-    }
+    if (g_pagedmem)
+        g_pagedmem->prev = page;
 
-    for (pageinfo_t* i = g_pagedmem; i; i = i->next) {
-        if (i->next && i->next->ptr == ptr) {
-            tmp = i->next->next;
+    g_pagedmem = page;
 
-            memFree(i->next->ptr);
-            memFree(i->next);
+    return page;
+}
 
-            i->next = tmp;
+// remove memory page and release its glyphs
+void removeMemPage(pageinfo_t* page)
+{
+    rAssert(page);
+    rAssert(g_pagedmem);
 
-            SDL_Log("ASCII: removed memory page");
+    if (page->prev)
+        page->prev->next = page->next;
+    else
+        g_pagedmem = page->next;
 
-            return;
-        }
-    }
+    if (page->next)
+        page->next->prev = page->prev;
+
+    freePageGlyphs(page->ptr, page->len * (page->type == ASCII_OBJ_2D ? sizeof(ascii2_t) : sizeof(ascii3_t)));
+
+    memPoolFree(g_asciiPagePool, page);
 }
 
 // free all memory pages
 void freePages(void)
 {
-    if (!g_pagedmem)
-        return;
+    pageinfo_t* next;
 
-    pageinfo_t* tmp = NULL;
+    for (pageinfo_t* i = g_pagedmem; i; i = next) {
+        next = i->next;
 
-    for (pageinfo_t* i = g_pagedmem; i; i = i->next) {
-        memFree(i->ptr);
-        memFree(tmp);
+        freePageGlyphs(i->ptr, i->len * (i->type == ASCII_OBJ_2D ? sizeof(ascii2_t) : sizeof(ascii3_t)));
 
-        tmp = i;
+        memPoolFree(g_asciiPagePool, i);
     }
 
-    memFree(tmp);
-
     g_pagedmem = NULL;
 }
\ No newline at end of file
@@ -0,0 +1,485 @@
+#include <math.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#if defined __SSE2__
+    #include <emmintrin.h>
+#endif
+
+#include <ascii3d.h>
+#include <render.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+//
+//  Local types
+//
+
+// x, y and w rows of view projection, object offset folded into the last column
+typedef struct projrows_s {
+    f32 x[4];
+    f32 y[4];
+    f32 w[4];
+} projrows_t;
+
+asciicamera_t g_a3Camera;
+bool g_a3HasCamera = 0;
+bool g_a3Dirty = 1;
+
+// row major, column vectors, w of view projection is view depth
+f32 g_a3View[16];
+f32 g_a3ViewProj[16];
+f32 g_a3Focal = 1.0f;           // px, glyphs at this depth are drawn at ASCII_RENDER_SCALE
+f32 g_a3DepthScale = 1.0f;
+
+// batch scratch, order holds two key / index buffers for the radix sort
+ascii3dglyph_t* g_a3Glyphs = NULL;
+Uint64* g_a3Order = NULL;
+const Uint64* g_a3Sorted = NULL;
+u32 g_a3Capacity = 0;
+u32 g_a3Count = 0;
+u32 g_a3Submitted = 0;
+bool g_a3Active = 0;
+
+ascii3dstats_t g_a3Stats;
+
+//
+//  Local functions
+//
+static void mat4Mul(f32* out, const f32* a, const f32* b)
+{
+    for (u32 r = 0; r < 4; r++) {
+        for (u32 c = 0; c < 4; c++) {
+            out[r * 4 + c] =
+                a[r * 4 + 0] * b[0 * 4 + c] +
+                a[r * 4 + 1] * b[1 * 4 + c] +
+                a[r * 4 + 2] * b[2 * 4 + c] +
+                a[r * 4 + 3] * b[3 * 4 + c];
+        }
+    }
+}
+
+// view from camera basis, projection maps view space to pixels with the principal point at screen center
+static void buildMatrices(void)
+{
+    const asciicamera_t* cam = &g_a3Camera;
+
+    f32 cy = cosf(cam->yaw), sy = sinf(cam->yaw);
+    f32 cp = cosf(cam->pitch), sp = sinf(cam->pitch);
+
+    vec3f_t fwd = {sy * cp, -sp, cy * cp};
+    vec3f_t right = {cy, 0.0f, -sy};
+    vec3f_t down = {
+        fwd.y * right.z - fwd.z * right.y,
+        fwd.z * right.x - fwd.x * right.z,
+        fwd.x * right.y - fwd.y * right.x
+    };
+
+    const vec3f_t* axes[3] = {&right, &down, &fwd};
+
+    memset(g_a3View, 0, sizeof(g_a3View));
+
+    for (u32 r = 0; r < 3; r++) {
+        g_a3View[r * 4 + 0] = axes[r]->x;
+        g_a3View[r * 4 + 1] = axes[r]->y;
+        g_a3View[r * 4 + 2] = axes[r]->z;
+        g_a3View[r * 4 + 3] = -(axes[r]->x * cam->pos.x + axes[r]->y * cam->pos.y + axes[r]->z * cam->pos.z);
+    }
+
+    g_a3View[15] = 1.0f;
+
+    g_a3Focal = (WINDOW_HEIGHT / 2.0f) / tanf(cam->fov * SDL_PI_F / 360.0f);
+
+    const f32 proj[16] = {
+        g_a3Focal,  0.0f,       WINDOW_WIDTH / 2.0f,    0.0f,
+        0.0f,       g_a3Focal,  WINDOW_HEIGHT / 2.0f,   0.0f,
+        0.0f,       0.0f,       1.0f,                   0.0f,
+        0.0f,       0.0f,       1.0f,                   0.0f
+    };
+
+    mat4Mul(g_a3ViewProj, proj, g_a3View);
+
+    g_a3DepthScale = ASCII3D_DEPTH_MAX / (cam->farZ - cam->nearZ);
+    g_a3Dirty = 0;
+}
+
+static void foldOffset(projrows_t* rows, f32 dx, f32 dy, f32 dz)
+{
+    const f32* src[3] = {g_a3ViewProj, g_a3ViewProj + 4, g_a3ViewProj + 12};
+    f32* dst[3] = {rows->x, rows->y, rows->w};
+
+    for (u32 r = 0; r < 3; r++) {
+        dst[r][0] = src[r][0];
+        dst[r][1] = src[r][1];
+        dst[r][2] = src[r][2];
+        dst[r][3] = src[r][0] * dx + src[r][1] * dy + src[r][2] * dz + src[r][3];
+    }
+}
+
+static inline bool glyphValid(const ascii3_t* glyph)
+{
+    return (glyph->flags & ASCII_GLYPH_VISIBLE) && glyph->charID > 31 && glyph->charID < 127;
+}
+
+// project one glyph, returns 0 if it is culled
+static inline u32 projectGlyph(ascii3dglyph_t* out, const ascii3_t* glyph, const projrows_t* rows)
+{
+    if (!glyphValid(glyph))
+        return 0;
+
+    f32 x = glyph->xpos, y = glyph->ypos, z = glyph->zpos;
+    f32 w = rows->w[0] * x + rows->w[1] * y + rows->w[2] * z + rows->w[3];
+
+    if (!(w >= g_a3Camera.nearZ && w <= g_a3Camera.farZ))
+        return 0;
+
+    f32 inv = 1.0f / w;
+    f32 sx = (rows->x[0] * x + rows->x[1] * y + rows->x[2] * z + rows->x[3]) * inv;
+    f32 sy = (rows->y[0] * x + rows->y[1] * y + rows->y[2] * z + rows->y[3]) * inv;
+    f32 scale = ASCII_RENDER_SCALE * g_a3Focal * inv;
+    f32 ext = scale * RENDER_GLYPH_SIZE;
+
+    if (sx + ext < 0.0f || sx >= WINDOW_WIDTH || sy + ext < 0.0f || sy >= WINDOW_HEIGHT)
+        return 0;
+
+    out->xpos = sx;
+    out->ypos = sy;
+    out->scale = scale;
+    out->depth = (Uint32) SDL_min((g_a3Camera.farZ - w) * g_a3DepthScale, (f32) ASCII3D_DEPTH_MAX);
+    out->color = g_asciiPalette[glyph->color];
+    out->charID = (Uint32) glyph->charID;
+
+    return 1;
+}
+
+#if defined __SSE2__
+
+#define ASCII3D_KERNEL_NAME     "sse2"
+
+// four glyphs per step, positions gathered from the glyph structs, survivors compacted from the lane mask
+static u32 projectGlyphs(ascii3dglyph_t* out, const ascii3_t* buf, u32 len, const projrows_t* rows)
+{
+    const __m128 x0 = _mm_set1_ps(rows->x[0]), x1 = _mm_set1_ps(rows->x[1]);
+    const __m128 x2 = _mm_set1_ps(rows->x[2]), x3 = _mm_set1_ps(rows->x[3]);
+    const __m128 y0 = _mm_set1_ps(rows->y[0]), y1 = _mm_set1_ps(rows->y[1]);
+    const __m128 y2 = _mm_set1_ps(rows->y[2]), y3 = _mm_set1_ps(rows->y[3]);
+    const __m128 w0 = _mm_set1_ps(rows->w[0]), w1 = _mm_set1_ps(rows->w[1]);
+    const __m128 w2 = _mm_set1_ps(rows->w[2]), w3 = _mm_set1_ps(rows->w[3]);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 nearZ = _mm_set1_ps(g_a3Camera.nearZ);
+    const __m128 farZ = _mm_set1_ps(g_a3Camera.farZ);
+    const __m128 width = _mm_set1_ps((f32) WINDOW_WIDTH);
+    const __m128 height = _mm_set1_ps((f32) WINDOW_HEIGHT);
+    const __m128 scaleNum = _mm_set1_ps(ASCII_RENDER_SCALE * g_a3Focal);
+    const __m128 glyphSize = _mm_set1_ps((f32) RENDER_GLYPH_SIZE);
+    const __m128 depthScale = _mm_set1_ps(g_a3DepthScale);
+    const __m128 depthMax = _mm_set1_ps((f32) ASCII3D_DEPTH_MAX);
+
+    f32 sx[4], sy[4], sc[4];
+    Sint32 keys[4];
+
+    u32 n = 0, i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        const ascii3_t* g = buf + i;
+
+        __m128 x = _mm_setr_ps(g[0].xpos, g[1].xpos, g[2].xpos, g[3].xpos);
+        __m128 y = _mm_setr_ps(g[0].ypos, g[1].ypos, g[2].ypos, g[3].ypos);
+        __m128 z = _mm_setr_ps(g[0].zpos, g[1].zpos, g[2].zpos, g[3].zpos);
+
+        __m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, x), _mm_mul_ps(w1, y)), _mm_mul_ps(w2, z)), w3);
+        __m128 px = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x), _mm_mul_ps(x1, y)), _mm_mul_ps(x2, z)), x3);
+        __m128 py = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(y0, x), _mm_mul_ps(y1, y)), _mm_mul_ps(y2, z)), y3);
+
+        // lanes behind the near plane divide by zero or negative w, they are masked off below
+        __m128 inv = _mm_div_ps(one, w);
+        __m128 vx = _mm_mul_ps(px, inv);
+        __m128 vy = _mm_mul_ps(py, inv);
+        __m128 vs = _mm_mul_ps(scaleNum, inv);
+        __m128 ext = _mm_mul_ps(vs, glyphSize);
+
+        __m128 in = _mm_and_ps(_mm_cmpge_ps(w, nearZ), _mm_cmple_ps(w, farZ));
+
+        in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(vx, ext), zero), _mm_cmplt_ps(vx, width)));
+        in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(vy, ext), zero), _mm_cmplt_ps(vy, height)));
+
+        u32 mask = (u32) _mm_movemask_ps(in);
+
+        if (!mask)
+            continue;
+
+        _mm_storeu_ps(sx, vx);
+        _mm_storeu_ps(sy, vy);
+        _mm_storeu_ps(sc, vs);
+        _mm_storeu_si128((__m128i*) keys, _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(farZ, w), depthScale), depthMax)));
+
+        for (u32 k = 0; k < 4; k++) {
+            if (!(mask & (1u << k)) || !glyphValid(g + k))
+                continue;
+
+            out[n].xpos = sx[k];
+            out[n].ypos = sy[k];
+            out[n].scale = sc[k];
+            out[n].depth = (Uint32) keys[k];
+            out[n].color = g_asciiPalette[g[k].color];
+            out[n].charID = (Uint32) g[k].charID;
+            n++;
+        }
+    }
+
+    for (; i < len; i++)
+        n += projectGlyph(out + n, buf + i, rows);
+
+    return n;
+}
+
+#else
+
+#define ASCII3D_KERNEL_NAME     "scalar"
+
+static u32 projectGlyphs(ascii3dglyph_t* out, const ascii3_t* buf, u32 len, const projrows_t* rows)
+{
+    u32 n = 0;
+
+    for (u32 i = 0; i < len; i++)
+        n += projectGlyph(out + n, buf + i, rows);
+
+    return n;
+}
+
+#endif
+
+// grow scratch to hold at least count glyphs, projected glyphs are kept
+static bool reserveGlyphs(u32 count)
+{
+    u32 capacity = g_a3Capacity ? g_a3Capacity : ASCII3D_MIN_CAPACITY;
+
+    while (capacity < count)
+        capacity *= 2;
+
+    ascii3dglyph_t* glyphs = (ascii3dglyph_t*) memAlloc(capacity * sizeof(ascii3dglyph_t));
+
+    if (!glyphs)
+        return 0;
+
+    Uint64* order = (Uint64*) memAlloc(capacity * 2 * sizeof(Uint64));
+
+    if (!order) {
+        memFree(glyphs);
+        return 0;
+    }
+
+    if (g_a3Glyphs) {
+        memcpy(glyphs, g_a3Glyphs, g_a3Count * sizeof(ascii3dglyph_t));
+
+        memFree(g_a3Glyphs);
+        memFree(g_a3Order);
+    }
+
+    g_a3Glyphs = glyphs;
+    g_a3Order = order;
+    g_a3Capacity = capacity;
+
+    return 1;
+}
+
+//
+//  Public functions
+//
+
+// glyphs on the z = 0 plane are drawn where 2D mode would draw them, at the same size
+void ascii3DDefaultCamera(asciicamera_t* cam)
+{
+    rAssert(cam);
+
+    f32 focal = (WINDOW_HEIGHT / 2.0f) / tanf(ASCII3D_DEFAULT_FOV * SDL_PI_F / 360.0f);
+
+    cam->pos.x = WINDOW_WIDTH / 2.0f;
+    cam->pos.y = WINDOW_HEIGHT / 2.0f;
+    cam->pos.z = -focal;
+    cam->yaw = 0.0f;
+    cam->pitch = 0.0f;
+    cam->fov = ASCII3D_DEFAULT_FOV;
+    cam->nearZ = 1.0f;
+    cam->farZ = focal + 4096.0f;
+}
+
+void ascii3DSetCamera(const asciicamera_t* cam)
+{
+    rAssert(cam);
+    rAssert(cam->fov > 0.0f && cam->fov < 180.0f);
+    rAssertMsg(cam->nearZ > 0.0f && cam->farZ > cam->nearZ, "Invalid camera depth range");
+
+    g_a3Camera = *cam;
+    g_a3HasCamera = 1;
+    g_a3Dirty = 1;
+}
+
+void ascii3DGetCamera(asciicamera_t* cam)
+{
+    rAssert(cam);
+
+    if (!g_a3HasCamera)
+        ascii3DDefaultCamera(cam);
+    else
+        *cam = g_a3Camera;
+}
+
+// start a new batch, camera changes take effect here
+void ascii3DBegin(void)
+{
+    if (!g_a3HasCamera) {
+        ascii3DDefaultCamera(&g_a3Camera);
+        g_a3HasCamera = 1;
+        g_a3Dirty = 1;
+    }
+
+    if (g_a3Dirty)
+        buildMatrices();
+
+    g_a3Count = 0;
+    g_a3Submitted = 0;
+    g_a3Sorted = NULL;
+    g_a3Active = 1;
+}
+
+// transform and cull glyphs into the batch, offset is added to every glyph position
+void ascii3DSubmit(const ascii3_t* buf, u32 len, f32 dx, f32 dy, f32 dz)
+{
+    rAssert(buf);
+    rAssertMsg(g_a3Active, "ascii3DSubmit outside of ascii3DBegin / ascii3DFlush");
+
+    g_a3Submitted += len;
+    g_a3Sorted = NULL;
+
+    if (g_a3Count + len > g_a3Capacity && !reserveGlyphs(g_a3Count + len)) {
+        SDL_Log("Failed to grow 3D ASCII scratch, dropping %lu glyphs", len - (g_a3Capacity - g_a3Count));
+        len = g_a3Capacity - g_a3Count;
+    }
+
+    projrows_t rows;
+
+    foldOffset(&rows, dx, dy, dz);
+
+    g_a3Count += projectGlyphs(g_a3Glyphs + g_a3Count, buf, len, &rows);
+}
+
+// order batch back to front, two stable 8 bit radix passes over the depth keys, returns glyphs to draw
+u32 ascii3DSort(void)
+{
+    rAssert(g_a3Active);
+
+    if (g_a3Sorted)
+        return g_a3Count;
+
+    g_a3Stats.submitted = g_a3Submitted;
+    g_a3Stats.culled = g_a3Submitted - g_a3Count;
+    g_a3Stats.drawn = g_a3Count;
+    g_a3Stats.capacity = g_a3Capacity;
+
+    if (!g_a3Count) {
+        g_a3Sorted = g_a3Order;
+        return 0;
+    }
+
+    u32 counts[2][256];
+    Uint64* src = g_a3Order;
+    Uint64* dst = g_a3Order + g_a3Capacity;
+
+    memset(counts, 0, sizeof(counts));
+
+    for (u32 i = 0; i < g_a3Count; i++) {
+        Uint32 key = g_a3Glyphs[i].depth;
+
+        src[i] = (Uint64) key << 32 | i;
+
+        counts[0][key & 0xff]++;
+        counts[1][(key >> 8) & 0xff]++;
+    }
+
+    for (u32 pass = 0; pass < 2; pass++) {
+        u32 shift = 32 + pass * 8;
+
+        // every key has the same byte, e.g. flat scenes, order is unchanged
+        if (counts[pass][(src[0] >> shift) & 0xff] == g_a3Count)
+            continue;
+
+        u32 offset = 0;
+
+        for (u32 b = 0; b < 256; b++) {
+            u32 c = counts[pass][b];
+            counts[pass][b] = offset;
+            offset += c;
+        }
+
+        for (u32 i = 0; i < g_a3Count; i++)
+            dst[counts[pass][(src[i] >> shift) & 0xff]++] = src[i];
+
+        Uint64* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    g_a3Sorted = src;
+
+    return g_a3Count;
+}
+
+// draw batch back to front and end it
+void ascii3DFlush(void)
+{
+    if (!g_a3Active)
+        return;
+
+    u32 count = ascii3DSort();
+
+    for (u32 i = 0; i < count; i++) {
+        const ascii3dglyph_t* g = g_a3Glyphs + (Uint32) g_a3Sorted[i];
+
+        renderCharColor((i16) roundf(g->xpos), (i16) roundf(g->ypos), g->scale, g->color, (char) g->charID);
+    }
+
+    g_a3Count = 0;
+    g_a3Submitted = 0;
+    g_a3Sorted = NULL;
+    g_a3Active = 0;
+}
+
+void ascii3DCleanup(void)
+{
+    if (g_a3Glyphs) {
+        memFree(g_a3Glyphs);
+        memFree(g_a3Order);
+    }
+
+    g_a3Glyphs = NULL;
+    g_a3Order = NULL;
+    g_a3Sorted = NULL;
+    g_a3Capacity = 0;
+    g_a3Count = 0;
+    g_a3Submitted = 0;
+    g_a3Active = 0;
+}
+
+// glyph drawn at position order of the sorted batch, valid until the next begin or submit
+const ascii3dglyph_t* ascii3DGetGlyph(u32 order)
+{
+    rAssert(g_a3Sorted);
+    rAssert(order < g_a3Count);
+
+    return g_a3Glyphs + (Uint32) g_a3Sorted[order];
+}
+
+void ascii3DGetStats(ascii3dstats_t* stats)
+{
+    rAssert(stats);
+
+    *stats = g_a3Stats;
+}
+
+const char* ascii3DKernelName(void)
+{
+    return ASCII3D_KERNEL_NAME;
+}
@@ -0,0 +1,280 @@
+#include <math.h>
+#include <SDL3/SDL.h>
+
+#if defined __SSE2__
+    #include <emmintrin.h>
+#endif
+
+// avx2 path is compiled with a target attribute and only called after the cpu check
+#if defined __SSE2__ && (defined __GNUC__ || defined __clang__)
+    #include <immintrin.h>
+    #define ASCII_PLACE_HAS_AVX2
+    #define ASCII_PLACE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#include <asciiplace.h>
+#include <debug/rdebug.h>
+
+typedef u32 (*placefn_t)(asciiplaced_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy);
+
+const char* g_apKernelNames[ASCII_PLACE_KERNELS] = {"scalar", "sse2", "avx2"};
+
+placefn_t g_apKernels[ASCII_PLACE_KERNELS];
+u32 g_apKernel = ASCII_PLACE_KERNELS;   // selected on first use
+
+//
+//  Local functions
+//
+static inline bool placeValid(const ascii2_t* glyph)
+{
+    return (glyph->flags & ASCII_GLYPH_VISIBLE) && glyph->charID > 31 && glyph->charID < 127;
+}
+
+// reference for the vector kernels and their tails, same placement renderBuf2D did per glyph
+static u32 placeScalar(asciiplaced_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    u32 n = 0;
+
+    for (u32 i = 0; i < len; i++) {
+        if (!placeValid(src + i))
+            continue;
+
+        f32 x = asciiPosFromFixed(src[i].xpos) + dx;
+        f32 y = asciiPosFromFixed(src[i].ypos) + dy;
+
+        // glyphs of objects that straddle the screen edge
+        if (x + ASCII_GLYPH_EXTENT < -1.0f || x > WINDOW_WIDTH || y + ASCII_GLYPH_EXTENT < -1.0f || y > WINDOW_HEIGHT)
+            continue;
+
+        dst[n].dst.x = (f32) (i32) roundf(x);
+        dst[n].dst.y = (f32) (i32) roundf(y);
+        dst[n].dst.w = ASCII_GLYPH_EXTENT;
+        dst[n].dst.h = ASCII_GLYPH_EXTENT;
+        dst[n].color = g_asciiPalette[src[i].color];
+        dst[n].charID = src[i].charID;
+        n++;
+    }
+
+    return n;
+}
+
+#if defined __SSE2__
+
+// roundf semantics, halves away from zero, cvtps would round them to even
+static inline __m128 roundHalfAway4(__m128 v)
+{
+    __m128i t = _mm_cvttps_epi32(v);
+    __m128 frac = _mm_sub_ps(v, _mm_cvtepi32_ps(t));
+
+    t = _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f))));
+    t = _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(frac, _mm_set1_ps(-0.5f))));
+
+    return _mm_cvtepi32_ps(t);
+}
+
+// write rects of four glyphs, every lane is stored but only kept lanes advance n, so dst needs no bounds check
+static inline u32 emitLanes(asciiplaced_t* dst, u32 n, const ascii2_t* src, __m128 x, __m128 y, u32 keep)
+{
+    const __m128 ext = _mm_set1_ps(ASCII_GLYPH_EXTENT);
+
+    __m128 lo = _mm_unpacklo_ps(x, y);
+    __m128 hi = _mm_unpackhi_ps(x, y);
+
+    __m128 rects[4] = {_mm_movelh_ps(lo, ext), _mm_movehl_ps(ext, lo), _mm_movelh_ps(hi, ext), _mm_movehl_ps(ext, hi)};
+
+    for (u32 k = 0; k < 4; k++) {
+        _mm_storeu_ps(&dst[n].dst.x, rects[k]);
+        dst[n].color = g_asciiPalette[src[k].color];
+        dst[n].charID = src[k].charID;
+        n += (keep >> k) & 1;
+    }
+
+    return n;
+}
+
+// four glyphs per step, positions and byte fields separated with a shuffle instead of per field loads
+static u32 placeSSE2(asciiplaced_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / ASCII_POS_ONE);
+    const __m128 offx = _mm_set1_ps(dx);
+    const __m128 offy = _mm_set1_ps(dy);
+    const __m128 ext = _mm_set1_ps(ASCII_GLYPH_EXTENT);
+    const __m128 minEdge = _mm_set1_ps(-1.0f);
+    const __m128 width = _mm_set1_ps((f32) WINDOW_WIDTH);
+    const __m128 height = _mm_set1_ps((f32) WINDOW_HEIGHT);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i visible = _mm_set1_epi32(ASCII_GLYPH_VISIBLE);
+
+    u32 n = 0, i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        __m128i a = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (src + i)), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i b = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (src + i + 2)), _MM_SHUFFLE(3, 1, 2, 0));
+
+        __m128i xy = _mm_unpacklo_epi64(a, b);
+        __m128i fields = _mm_unpackhi_epi64(a, b);
+
+        __m128 x = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16)), scale), offx);
+        __m128 y = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(xy, 16)), scale), offy);
+
+        __m128i id = _mm_and_si128(_mm_srli_epi32(fields, 8), byteMask);
+        __m128i valid = _mm_and_si128(_mm_cmpgt_epi32(id, _mm_set1_epi32(31)), _mm_cmplt_epi32(id, _mm_set1_epi32(127)));
+
+        valid = _mm_and_si128(valid, _mm_cmpeq_epi32(_mm_and_si128(_mm_srli_epi32(fields, 16), visible), visible));
+
+        __m128 cull = _mm_or_ps(_mm_cmplt_ps(_mm_add_ps(x, ext), minEdge), _mm_cmpgt_ps(x, width));
+
+        cull = _mm_or_ps(cull, _mm_or_ps(_mm_cmplt_ps(_mm_add_ps(y, ext), minEdge), _mm_cmpgt_ps(y, height)));
+
+        u32 keep = (u32) _mm_movemask_ps(_mm_andnot_ps(cull, _mm_castsi128_ps(valid)));
+
+        if (!keep)
+            continue;
+
+        n = emitLanes(dst, n, src + i, roundHalfAway4(x), roundHalfAway4(y), keep);
+    }
+
+    return n + placeScalar(dst + n, src + i, len - i, dx, dy);
+}
+
+#endif
+
+#if defined ASCII_PLACE_HAS_AVX2
+
+ASCII_PLACE_TARGET_AVX2
+static inline __m256 roundHalfAway8(__m256 v)
+{
+    __m256i t = _mm256_cvttps_epi32(v);
+    __m256 frac = _mm256_sub_ps(v, _mm256_cvtepi32_ps(t));
+
+    t = _mm256_sub_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(frac, _mm256_set1_ps(0.5f), _CMP_GE_OQ)));
+    t = _mm256_add_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(frac, _mm256_set1_ps(-0.5f), _CMP_LE_OQ)));
+
+    return _mm256_cvtepi32_ps(t);
+}
+
+// eight glyphs per step, same lanes as sse2 with a cross lane permute to separate the fields
+ASCII_PLACE_TARGET_AVX2
+static u32 placeAVX2(asciiplaced_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / ASCII_POS_ONE);
+    const __m256 offx = _mm256_set1_ps(dx);
+    const __m256 offy = _mm256_set1_ps(dy);
+    const __m256 ext = _mm256_set1_ps(ASCII_GLYPH_EXTENT);
+    const __m256 minEdge = _mm256_set1_ps(-1.0f);
+    const __m256 width = _mm256_set1_ps((f32) WINDOW_WIDTH);
+    const __m256 height = _mm256_set1_ps((f32) WINDOW_HEIGHT);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i visible = _mm256_set1_epi32(ASCII_GLYPH_VISIBLE);
+    const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+    u32 n = 0, i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*) (src + i)), split);
+        __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*) (src + i + 4)), split);
+
+        __m256i xy = _mm256_permute2x128_si256(a, b, 0x20);
+        __m256i fields = _mm256_permute2x128_si256(a, b, 0x31);
+
+        __m256 x = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(xy, 16), 16)), scale), offx);
+        __m256 y = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(xy, 16)), scale), offy);
+
+        __m256i id = _mm256_and_si256(_mm256_srli_epi32(fields, 8), byteMask);
+        __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(id, _mm256_set1_epi32(31)), _mm256_cmpgt_epi32(_mm256_set1_epi32(127), id));
+
+        valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srli_epi32(fields, 16), visible), visible));
+
+        __m256 cull = _mm256_or_ps(_mm256_cmp_ps(_mm256_add_ps(x, ext), minEdge, _CMP_LT_OQ), _mm256_cmp_ps(x, width, _CMP_GT_OQ));
+
+        cull = _mm256_or_ps(cull, _mm256_or_ps(_mm256_cmp_ps(_mm256_add_ps(y, ext), minEdge, _CMP_LT_OQ), _mm256_cmp_ps(y, height, _CMP_GT_OQ)));
+
+        u32 keep = (u32) _mm256_movemask_ps(_mm256_andnot_ps(cull, _mm256_castsi256_ps(valid)));
+
+        if (!keep)
+            continue;
+
+        __m256 rx = roundHalfAway8(x);
+        __m256 ry = roundHalfAway8(y);
+
+        n = emitLanes(dst, n, src + i, _mm256_castps256_ps128(rx), _mm256_castps256_ps128(ry), keep & 0xf);
+        n = emitLanes(dst, n, src + i + 4, _mm256_extractf128_ps(rx, 1), _mm256_extractf128_ps(ry, 1), keep >> 4);
+    }
+
+    return n + placeSSE2(dst + n, src + i, len - i, dx, dy);
+}
+
+#endif
+
+static void initKernels(void)
+{
+    g_apKernels[ASCII_PLACE_KERNEL_SCALAR] = placeScalar;
+
+#if defined __SSE2__
+    if (SDL_HasSSE2())
+        g_apKernels[ASCII_PLACE_KERNEL_SSE2] = placeSSE2;
+#endif
+
+#if defined ASCII_PLACE_HAS_AVX2
+    if (SDL_HasAVX2())
+        g_apKernels[ASCII_PLACE_KERNEL_AVX2] = placeAVX2;
+#endif
+
+    // widest supported kernel by default
+    g_apKernel = ASCII_PLACE_KERNEL_SCALAR;
+
+    for (u32 i = 1; i < ASCII_PLACE_KERNELS; i++) {
+        if (g_apKernels[i])
+            g_apKernel = i;
+    }
+}
+
+//
+//  Public functions
+//
+
+// offset, round and cull a glyph array into draw rects, dst must hold len glyphs, returns number written
+u32 asciiPlace2D(asciiplaced_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    rAssert(dst);
+    rAssert(src || !len);
+
+    if (g_apKernel == ASCII_PLACE_KERNELS)
+        initKernels();
+
+    return g_apKernels[g_apKernel](dst, src, len, dx, dy);
+}
+
+// force kernel for comparisons, false if it is not built or the cpu lacks it
+bool asciiPlaceSetKernel(u32 kernel)
+{
+    if (!asciiPlaceKernelSupported(kernel))
+        return 0;
+
+    g_apKernel = kernel;
+
+    return 1;
+}
+
+u32 asciiPlaceGetKernel(void)
+{
+    if (g_apKernel == ASCII_PLACE_KERNELS)
+        initKernels();
+
+    return g_apKernel;
+}
+
+bool asciiPlaceKernelSupported(u32 kernel)
+{
+    if (g_apKernel == ASCII_PLACE_KERNELS)
+        initKernels();
+
+    return kernel < ASCII_PLACE_KERNELS && g_apKernels[kernel];
+}
+
+const char* asciiPlaceKernelName(u32 kernel)
+{
+    rAssert(kernel < ASCII_PLACE_KERNELS);
+
+    return g_apKernelNames[kernel];
+}
@@ -0,0 +1,892 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <bench.h>
+#include <ascii.h>
+#include <ascii3d.h>
+#include <asciiplace.h>
+#include <objects.h>
+#include <render.h>
+#include <rng.h>
+#include <debug/rdebug.h>
+
+#define BENCH_KERNEL_GLYPHS     4096    // glyphs copied per timed iteration
+#define BENCH_KERNEL_CHECKS     1024    // random arrays compared against reference
+#define BENCH_KERNEL_MAX_LEN    67      // odd max length so every tail length gets hit
+#define BENCH_KERNEL_OBJECTS    12      // objects queued per frame in queue check
+#define BENCH_PLACE_OBJECTS     64      // pipe head sized objects placed per timed iteration
+#define BENCH_PLACE_GLYPHS      10000   // stress array placed in one call
+#define BENCH_3D_GLYPHS         100000  // glyphs projected and sorted per timed iteration
+#define BENCH_3D_CHECK_GLYPHS   256
+#define BENCH_SLOT_OBJECTS      16      // live objects in char slot check, page pools run out past that
+#define BENCH_SLOT_OPS          8192    // random allocs and frees per mode and scale
+
+// palette colors only, random colors would fill the shared palette and fall back to nearest lookups
+const u32 g_bColors[] = {COLOR_WHITE, COLOR_RED, COLOR_GREEN, COLOR_BLUE, COLOR_YELLOW, COLOR_GOLD, COLOR_PURPLE, COLOR_AZURE};
+
+ascii2_t g_bSrc2[BENCH_KERNEL_GLYPHS];
+ascii2_t g_bDst2[BENCH_KERNEL_GLYPHS];
+ascii3_t g_bSrc3[BENCH_KERNEL_GLYPHS];
+ascii3_t g_bDst3[BENCH_KERNEL_GLYPHS];
+
+//
+//  Reference, copy first then translate in place like render queue did before the kernel
+//
+static Sint16 saturate16(i32 value)
+{
+    return (Sint16) (value < -32768 ? -32768 : value > 32767 ? 32767 : value);
+}
+
+static void twoPass2D(ascii2_t* dst, const ascii2_t* src, u32 len, f32 dx, f32 dy)
+{
+    Sint16 fx = asciiPosToFixed(dx);
+    Sint16 fy = asciiPosToFixed(dy);
+
+    memcpy(dst, src, len * sizeof(ascii2_t));
+
+    for (u32 i = 0; i < len; i++) {
+        dst[i].xpos = saturate16(dst[i].xpos + fx);
+        dst[i].ypos = saturate16(dst[i].ypos + fy);
+    }
+}
+
+static void twoPass3D(ascii3_t* dst, const ascii3_t* src, u32 len, f32 dx, f32 dy, f32 dz)
+{
+    memcpy(dst, src, len * sizeof(ascii3_t));
+
+    for (u32 i = 0; i < len; i++) {
+        dst[i].xpos += dx;
+        dst[i].ypos += dy;
+        dst[i].zpos += dz;
+    }
+}
+
+static f32 randomCoord(rng_t* rng)
+{
+    return (f32) (rngNext(rng) % 2048) - 1024.0f + (f32) (rngNext(rng) % 256) / 256.0f;
+}
+
+// random bytes everywhere, then sane 3D positions, color, id and flag bits must come through untouched
+// 2D positions keep the random bits, fixed point covers the whole range and sums near the ends saturate
+static void fillGlyphs(rng_t* rng)
+{
+    Uint32* words2 = (Uint32*) g_bSrc2;
+    Uint32* words3 = (Uint32*) g_bSrc3;
+
+    for (u32 i = 0; i < BENCH_KERNEL_GLYPHS * sizeof(ascii2_t) / sizeof(Uint32); i++)
+        words2[i] = rngNext(rng);
+
+    for (u32 i = 0; i < BENCH_KERNEL_GLYPHS * sizeof(ascii3_t) / sizeof(Uint32); i++)
+        words3[i] = rngNext(rng);
+
+    for (u32 i = 0; i < BENCH_KERNEL_GLYPHS; i++) {
+        g_bSrc3[i].xpos = randomCoord(rng);
+        g_bSrc3[i].ypos = randomCoord(rng);
+        g_bSrc3[i].zpos = randomCoord(rng);
+    }
+}
+
+// kernel output must match reference bit for bit, lengths cover empty arrays and all tails
+static void checkKernels(rng_t* rng)
+{
+    static ascii2_t ref2[BENCH_KERNEL_MAX_LEN];
+    static ascii3_t ref3[BENCH_KERNEL_MAX_LEN];
+
+    for (u32 i = 0; i < BENCH_KERNEL_CHECKS; i++) {
+        u32 len = i % (BENCH_KERNEL_MAX_LEN + 1);
+        u32 first = rngNext(rng) % (BENCH_KERNEL_GLYPHS - BENCH_KERNEL_MAX_LEN);
+
+        f32 dx = randomCoord(rng);
+        f32 dy = randomCoord(rng);
+        f32 dz = randomCoord(rng);
+
+        twoPass2D(ref2, g_bSrc2 + first, len, dx, dy);
+        asciiCopyOffset2D(g_bDst2, g_bSrc2 + first, len, dx, dy);
+
+        if (memcmp(ref2, g_bDst2, len * sizeof(ascii2_t))) {
+            benchFail("asciiCopyOffset2D: output differs from reference");
+            return;
+        }
+
+        twoPass3D(ref3, g_bSrc3 + first, len, dx, dy, dz);
+        asciiCopyOffset3D(g_bDst3, g_bSrc3 + first, len, dx, dy, dz);
+
+        if (memcmp(ref3, g_bDst3, len * sizeof(ascii3_t))) {
+            benchFail("asciiCopyOffset3D: output differs from reference");
+            return;
+        }
+    }
+}
+
+// glyphs of every queued object, in submission order across chunks
+static u32 readQueue(void* out, u32 size, u32 max)
+{
+    u32 count = 0;
+
+    for (const renderchunk_t* i = asciiGetRenderQueue(); i; i = i->next) {
+        u32 n = i->used / size;
+
+        if (count + n > max)
+            return max + 1;
+
+        memcpy((char*) out + count * size, i->mem, n * size);
+        count += n;
+    }
+
+    return count;
+}
+
+// several objects with their own offsets per frame, each must be translated once by its own offset
+static void checkQueue2D(rng_t* rng)
+{
+    static ascii2_t ref[BENCH_KERNEL_MAX_LEN];
+
+    asciiobj_t* objects[BENCH_KERNEL_OBJECTS];
+    ascii2info_t info[BENCH_KERNEL_MAX_LEN];
+    u32 total = 0;
+
+    asciiResetAll();
+
+    for (u32 k = 0; k < BENCH_KERNEL_OBJECTS; k++) {
+        u32 len = 1 + rngNext(rng) % BENCH_KERNEL_MAX_LEN;
+
+        for (u32 i = 0; i < len; i++) {
+            info[i].charID = 33 + rngNext(rng) % 94;
+            info[i].color = g_bColors[rngNext(rng) % SDL_arraysize(g_bColors)];
+            info[i].pos.x = (f32) (rngNext(rng) % 200);
+            info[i].pos.y = (f32) (rngNext(rng) % 100);
+        }
+
+        if (!(objects[k] = asciiObject2DIStruct(info, len))) {
+            benchFail("asciiQueue2D: object allocation failed");
+            asciiResetAll();
+            return;
+        }
+
+        // one object without offset takes the plain copy path, all stay on screen so none are culled
+        objects[k]->xpos = k ? randomCoord(rng) * 0.5f + 512.0f : 0.0f;
+        objects[k]->ypos = k ? randomCoord(rng) * 0.25f + 300.0f : 0.0f;
+    }
+
+    // objects are queued twice, second round must not see offsets of the first
+    for (u32 r = 0; r < 2; r++) {
+        for (u32 k = 0; k < BENCH_KERNEL_OBJECTS; k++) {
+            renderAsciiObject2D(objects[k]);
+            total += objects[k]->len;
+        }
+    }
+
+    u32 count = readQueue(g_bDst2, sizeof(ascii2_t), BENCH_KERNEL_GLYPHS);
+
+    if (count != total) {
+        benchFail("asciiQueue2D: queued glyph count differs");
+        asciiResetAll();
+        return;
+    }
+
+    u32 idx = 0;
+
+    for (u32 r = 0; r < 2; r++) {
+        for (u32 k = 0; k < BENCH_KERNEL_OBJECTS; k++) {
+            twoPass2D(ref, objects[k]->data.ascii2, objects[k]->len, objects[k]->xpos, objects[k]->ypos);
+
+            if (memcmp(ref, g_bDst2 + idx, objects[k]->len * sizeof(ascii2_t))) {
+                benchFail("asciiQueue2D: queued glyphs differ from reference");
+                asciiResetAll();
+                return;
+            }
+
+            idx += objects[k]->len;
+        }
+    }
+
+    asciiResetAll();
+}
+
+// objects whose bounds miss the viewport are not queued, objects straddling an edge are queued whole
+static void checkCulling2D(void)
+{
+    asciiResetAll();
+
+    asciiobj_t* object = asciiObject2DIStruct(o_asciiPipeHeadTop, O_PIPE_HEAD_TOP_LEN);
+
+    if (!object) {
+        benchFail("asciiCulling2D: object allocation failed");
+        return;
+    }
+
+    for (u32 i = 0; i < object->len; i++) {
+        f32 x = asciiPosFromFixed(object->data.ascii2[i].xpos);
+        f32 y = asciiPosFromFixed(object->data.ascii2[i].ypos);
+
+        if (x < object->bmin.x || x >= object->bmax.x || y < object->bmin.y || y >= object->bmax.y) {
+            benchFail("asciiCulling2D: glyph outside object bounds");
+            asciiResetAll();
+            return;
+        }
+    }
+
+    f32 w = object->bmax.x - object->bmin.x;
+    f32 h = object->bmax.y - object->bmin.y;
+
+    // offset, glyphs expected in queue
+    const f32 cases[6][3] = {
+        {-object->bmax.x - 2.0f,                100.0f,                                 0.0f},
+        {WINDOW_WIDTH - object->bmin.x + 2.0f,  100.0f,                                 0.0f},
+        {100.0f,                                -object->bmax.y - 2.0f,                 0.0f},
+        {100.0f,                                WINDOW_HEIGHT - object->bmin.y + 2.0f,  0.0f},
+        {-object->bmin.x - w / 2.0f,            100.0f,                                 1.0f},
+        {100.0f,                                WINDOW_HEIGHT - object->bmin.y - h / 2.0f, 1.0f}
+    };
+
+    for (u32 c = 0; c < 6; c++) {
+        object->xpos = cases[c][0];
+        object->ypos = cases[c][1];
+
+        renderAsciiObject2D(object);
+
+        u32 expected = cases[c][2] > 0.0f ? object->len : 0;
+
+        if (readQueue(g_bDst2, sizeof(ascii2_t), BENCH_KERNEL_GLYPHS) != expected) {
+            benchFail("asciiCulling2D: object culled wrongly");
+            break;
+        }
+
+        asciiRender2D(COLOR_BLACK, 0, 0);
+    }
+
+    asciiResetAll();
+}
+
+static void checkQueue3D(rng_t* rng)
+{
+    static ascii3_t ref[BENCH_KERNEL_MAX_LEN];
+
+    asciiobj_t* objects[BENCH_KERNEL_OBJECTS];
+    ascii3info_t info[BENCH_KERNEL_MAX_LEN];
+    u32 total = 0;
+
+    asciiChangeMode(ASCII_RENDER_MODE_3D);
+
+    for (u32 k = 0; k < BENCH_KERNEL_OBJECTS; k++) {
+        u32 len = 1 + rngNext(rng) % BENCH_KERNEL_MAX_LEN;
+
+        for (u32 i = 0; i < len; i++) {
+            info[i].charID = 33 + rngNext(rng) % 94;
+            info[i].color = g_bColors[rngNext(rng) % SDL_arraysize(g_bColors)];
+            info[i].pos.x = randomCoord(rng);
+            info[i].pos.y = randomCoord(rng);
+            info[i].pos.z = randomCoord(rng);
+        }
+
+        if (!(objects[k] = asciiObject3DIStruct(info, len))) {
+            benchFail("asciiQueue3D: object allocation failed");
+            asciiChangeMode(ASCII_RENDER_MODE_2D);
+            return;
+        }
+
+        objects[k]->xpos = k ? randomCoord(rng) : 0.0f;
+        objects[k]->ypos = k ? randomCoord(rng) : 0.0f;
+        objects[k]->zpos = k ? randomCoord(rng) : 0.0f;
+    }
+
+    for (u32 k = 0; k < BENCH_KERNEL_OBJECTS; k++) {
+        renderAsciiObject3D(objects[k]);
+        total += objects[k]->len;
+    }
+
+    u32 count = readQueue(g_bDst3, sizeof(ascii3_t), BENCH_KERNEL_GLYPHS);
+
+    if (count != total) {
+        benchFail("asciiQueue3D: queued glyph count differs");
+        asciiChangeMode(ASCII_RENDER_MODE_2D);
+        return;
+    }
+
+    u32 idx = 0;
+
+    for (u32 k = 0; k < BENCH_KERNEL_OBJECTS; k++) {
+        asciiobj_t* o = objects[k];
+
+        twoPass3D(ref, o->data.ascii3, o->len, o->xpos, o->ypos, o->zpos);
+
+        if (memcmp(ref, g_bDst3 + idx, o->len * sizeof(ascii3_t))) {
+            benchFail("asciiQueue3D: queued glyphs differ from reference");
+            break;
+        }
+
+        idx += o->len;
+    }
+
+    asciiChangeMode(ASCII_RENDER_MODE_2D);
+}
+
+//
+//  Char buf slots, first fit over the occupancy map against a plain slot array
+//
+typedef struct slotcheck_s {
+    u32 mode;
+    u32 slots;          // slots that fit the char buf in this mode
+    u32 size;
+    u32 live;
+    bool used[ASCII_CHAR_MAP_WORDS * 64];
+    asciiobj_t* objects[BENCH_SLOT_OBJECTS];
+} slotcheck_t;
+
+// lowest slot of the first free run of len slots, -1 if there is none
+static i32 refFirstFit(const slotcheck_t* c, u32 len)
+{
+    u32 run = 0;
+
+    for (u32 i = 0; i < c->slots; i++) {
+        run = c->used[i] ? 0 : run + 1;
+
+        if (run == len)
+            return i + 1 - len;
+    }
+
+    return -1;
+}
+
+static bool refMapMatches(const slotcheck_t* c)
+{
+    for (u32 i = 0; i < ASCII_CHAR_MAP_WORDS * 64; i++) {
+        bool bit = (g_charMap[i / 64] >> (i % 64)) & 1;
+
+        // tail slots past the buf stay marked so they are never handed out
+        if (bit != (i >= c->slots || c->used[i]))
+            return 0;
+    }
+
+    return 1;
+}
+
+// allocate object k and compare its placement with reference, 0 on mismatch
+static bool slotAlloc(slotcheck_t* c, u32 k, u32 len)
+{
+    i32 expect = refFirstFit(c, len);
+    asciiobj_t* o = getAsciiObj(c->mode, len);
+
+    c->objects[k] = o;
+
+    if (!o) {
+        // page pools are small, running out of them is fine once the char buf is full
+        if (expect < 0)
+            return 1;
+
+        SDL_Log("char slots: %lu slots free at %ld but allocation failed", len, expect);
+        return 0;
+    }
+
+    c->live++;
+
+    if (expect < 0) {
+        if (o->page)
+            return 1;
+
+        SDL_Log("char slots: %lu slots do not fit but object is in char buf", len);
+        return 0;
+    }
+
+    i32 slot = o->page ? -1 : (i32) (((char*) o->data.ascii2 - (char*) g_charbuf) / c->size);
+
+    if (slot != expect) {
+        SDL_Log("char slots: %lu slots placed at %ld, first fit is %ld", len, slot, expect);
+        return 0;
+    }
+
+    for (u32 i = 0; i < len; i++)
+        c->used[slot + i] = 1;
+
+    return 1;
+}
+
+static void slotFree(slotcheck_t* c, u32 k)
+{
+    asciiobj_t* o = c->objects[k];
+
+    if (!o->page) {
+        u32 slot = ((char*) o->data.ascii2 - (char*) g_charbuf) / c->size;
+
+        for (u32 i = 0; i < o->len; i++)
+            c->used[slot + i] = 0;
+    }
+
+    removeAsciiObject(o);
+
+    c->objects[k] = NULL;
+    c->live--;
+}
+
+static void slotFreeAll(slotcheck_t* c)
+{
+    for (u32 k = 0; k < BENCH_SLOT_OBJECTS; k++) {
+        if (c->objects[k])
+            slotFree(c, k);
+    }
+}
+
+// fixed cases first: runs across map words, a request bigger than the free space and a full buf
+static bool slotEdgeCases(slotcheck_t* c)
+{
+    // 60 + 10 crosses slot 64, then 70 does not fit in the 60 before it and crosses 128
+    if (!slotAlloc(c, 0, 60) || !slotAlloc(c, 1, 10))
+        return 0;
+
+    slotFree(c, 0);
+
+    if (!slotAlloc(c, 0, 70) || !slotAlloc(c, 2, 60))
+        return 0;
+
+    // one more than is free anywhere must go to a page
+    if (!slotAlloc(c, 3, c->slots - 140 + 1) || !c->objects[3] || !c->objects[3]->page) {
+        SDL_Log("char slots: request bigger than free space was not paged");
+        return 0;
+    }
+
+    slotFreeAll(c);
+
+    // whole buf in one object, the next slot would be in the 3D tail
+    if (!slotAlloc(c, 0, c->slots) || !slotAlloc(c, 1, 1) || !refMapMatches(c)) {
+        SDL_Log("char slots: full buf handed out a slot past its end");
+        return 0;
+    }
+
+    slotFreeAll(c);
+
+    return refMapMatches(c);
+}
+
+// random alloc and free against reference first fit, len is mostly small and sometimes past the whole buf
+static void checkCharSlots(rng_t* rng, u32 mode, u32 ops)
+{
+    static slotcheck_t c;
+
+    if (mode == ASCII_RENDER_MODE_3D)
+        asciiChangeMode(ASCII_RENDER_MODE_3D);
+    else
+        asciiResetAll();
+
+    memset(&c, 0, sizeof(c));
+
+    c.mode = mode;
+    c.size = mode == ASCII_RENDER_MODE_2D ? sizeof(ascii2_t) : sizeof(ascii3_t);
+    c.slots = ASCII_CHAR_BUF_SIZE / c.size;
+
+    const char* name = mode == ASCII_RENDER_MODE_2D ? "char slots 2D" : "char slots 3D";
+    bool match = slotEdgeCases(&c);
+
+    for (u32 i = 0; i < ops && match; i++) {
+        u32 k = rngNext(rng) % BENCH_SLOT_OBJECTS;
+
+        if (c.objects[k]) {
+            slotFree(&c, k);
+        } else {
+            u32 len = rngNext(rng) % 16 ? 1 + rngNext(rng) % 96 : 1 + rngNext(rng) % (c.slots + 64);
+
+            match = slotAlloc(&c, k, len);
+        }
+
+        if (match && !refMapMatches(&c)) {
+            SDL_Log("%s: occupancy map differs from reference after %lu ops", name, i + 1);
+            match = 0;
+        }
+    }
+
+    if (!match)
+        benchFail(mode == ASCII_RENDER_MODE_2D ? "char slots 2D: allocator differs from first fit" : "char slots 3D: allocator differs from first fit");
+
+    slotFreeAll(&c);
+
+    if (mode == ASCII_RENDER_MODE_3D)
+        asciiChangeMode(ASCII_RENDER_MODE_2D);
+    else
+        asciiResetAll();
+}
+
+//
+//  Timed copies, two pass reference against single pass kernel
+//
+static void timeCopy2D(const char* name, u32 iterations, bool kernel)
+{
+    for (u32 i = 0; i < iterations; i++) {
+        f32 d = (f32) (i & 15);
+        u64 start = SDL_GetTicksNS();
+
+        if (kernel)
+            asciiCopyOffset2D(g_bDst2, g_bSrc2, BENCH_KERNEL_GLYPHS, d, -d);
+        else
+            twoPass2D(g_bDst2, g_bSrc2, BENCH_KERNEL_GLYPHS, d, -d);
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    benchReport(name, "glyphs", iterations, BENCH_KERNEL_GLYPHS);
+}
+
+static void timeCopy3D(const char* name, u32 iterations, bool kernel)
+{
+    for (u32 i = 0; i < iterations; i++) {
+        f32 d = (f32) (i & 15);
+        u64 start = SDL_GetTicksNS();
+
+        if (kernel)
+            asciiCopyOffset3D(g_bDst3, g_bSrc3, BENCH_KERNEL_GLYPHS, d, -d, d);
+        else
+            twoPass3D(g_bDst3, g_bSrc3, BENCH_KERNEL_GLYPHS, d, -d, d);
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    benchReport(name, "glyphs", iterations, BENCH_KERNEL_GLYPHS);
+}
+
+// copy and translate kernels of the render queue, checked against reference before timing
+void benchAsciiKernels(u32 scale)
+{
+    u32 iterations = 512 * scale;
+    rng_t rng;
+
+    rAssert(iterations <= BENCH_MAX_SAMPLES);
+
+    rngSeed(&rng, 17);
+
+    fillGlyphs(&rng);
+
+    checkKernels(&rng);
+    checkQueue2D(&rng);
+    checkCulling2D();
+    checkQueue3D(&rng);
+    checkCharSlots(&rng, ASCII_RENDER_MODE_2D, BENCH_SLOT_OPS * scale);
+    checkCharSlots(&rng, ASCII_RENDER_MODE_3D, BENCH_SLOT_OPS * scale);
+
+    SDL_Log("ascii copy kernel: %s", asciiCopyKernelName());
+
+    timeCopy2D("asciiCopyOffset2D.twoPass", iterations, 0);
+    timeCopy2D("asciiCopyOffset2D.kernel", iterations, 1);
+    timeCopy3D("asciiCopyOffset3D.twoPass", iterations, 0);
+    timeCopy3D("asciiCopyOffset3D.kernel", iterations, 1);
+}
+
+//
+//  Placement kernels, every kernel the cpu supports must match scalar placement bit for bit
+//
+static void randomPlaceGlyphs(rng_t* rng, ascii2_t* glyphs, u32 len)
+{
+    for (u32 i = 0; i < len; i++) {
+        // whole px and exact halves for the rounding, random flags and ids for the validity test
+        glyphs[i].xpos = (Sint16) ((i32) (rngNext(rng) % ((WINDOW_WIDTH + 100) * ASCII_POS_ONE)) - 50 * ASCII_POS_ONE);
+        glyphs[i].ypos = (Sint16) ((i32) (rngNext(rng) % ((WINDOW_HEIGHT + 100) * ASCII_POS_ONE)) - 50 * ASCII_POS_ONE);
+        glyphs[i].color = (Uint8) rngNext(rng);
+        glyphs[i].charID = (Uint8) (rngNext(rng) % 8 ? 33 + rngNext(rng) % 94 : rngNext(rng));
+        glyphs[i].flags = (Uint8) (rngNext(rng) % 8 ? ASCII_GLYPH_VISIBLE : rngNext(rng));
+        glyphs[i].pad = 0;
+    }
+}
+
+static void checkPlace(rng_t* rng, ascii2_t* glyphs, asciiplaced_t* out)
+{
+    static asciiplaced_t ref[BENCH_KERNEL_MAX_LEN];
+
+    u32 kernel = asciiPlaceGetKernel();
+
+    randomPlaceGlyphs(rng, glyphs, BENCH_PLACE_GLYPHS);
+
+    for (u32 k = 1; k < ASCII_PLACE_KERNELS; k++) {
+        if (!asciiPlaceKernelSupported(k))
+            continue;
+
+        for (u32 i = 0; i < BENCH_KERNEL_CHECKS; i++) {
+            u32 len = i % (BENCH_KERNEL_MAX_LEN + 1);
+            u32 first = rngNext(rng) % (BENCH_PLACE_GLYPHS - BENCH_KERNEL_MAX_LEN);
+
+            f32 dx = (f32) (rngNext(rng) % 64) * 0.25f - 8.0f;
+            f32 dy = (f32) (rngNext(rng) % 64) * 0.25f - 8.0f;
+
+            asciiPlaceSetKernel(ASCII_PLACE_KERNEL_SCALAR);
+            u32 count = asciiPlace2D(ref, glyphs + first, len, dx, dy);
+
+            asciiPlaceSetKernel(k);
+
+            if (asciiPlace2D(out, glyphs + first, len, dx, dy) != count || memcmp(ref, out, count * sizeof(asciiplaced_t))) {
+                benchFail("asciiPlace2D: kernel output differs from scalar placement");
+                asciiPlaceSetKernel(kernel);
+                return;
+            }
+        }
+    }
+
+    asciiPlaceSetKernel(kernel);
+}
+
+static void timePlace(u32 kernel, u32 iterations, const ascii2_t* head, const ascii2_t* glyphs, asciiplaced_t* out)
+{
+    char name[64];
+
+    asciiPlaceSetKernel(kernel);
+
+    // many small objects, per call overhead and tails count
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_PLACE_OBJECTS; k++)
+            asciiPlace2D(out + k * O_PIPE_HEAD_BOT_LEN, head, O_PIPE_HEAD_BOT_LEN, (f32) (k * 20) + (f32) (i & 3) * 0.25f, (f32) (k * 11));
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    SDL_snprintf(name, sizeof(name), "asciiPlace2D.pipeHead.%s", asciiPlaceKernelName(kernel));
+    benchReport(name, "glyphs", iterations, BENCH_PLACE_OBJECTS * O_PIPE_HEAD_BOT_LEN);
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        asciiPlace2D(out, glyphs, BENCH_PLACE_GLYPHS, (f32) (i & 3) * 0.25f, 0.0f);
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    SDL_snprintf(name, sizeof(name), "asciiPlace2D.stress.%s", asciiPlaceKernelName(kernel));
+    benchReport(name, "glyphs", iterations, BENCH_PLACE_GLYPHS);
+}
+
+// offset, round and cull of 2D glyphs, scalar is the per glyph placement renderBuf2D used to do
+void benchAsciiPlace(u32 scale)
+{
+    u32 iterations = 256 * scale;
+    rng_t rng;
+
+    rAssert(iterations <= BENCH_MAX_SAMPLES);
+
+    ascii2_t* glyphs = malloc(BENCH_PLACE_GLYPHS * sizeof(ascii2_t));
+    asciiplaced_t* out = malloc(BENCH_PLACE_GLYPHS * sizeof(asciiplaced_t));
+
+    if (!glyphs || !out) {
+        benchFail("asciiPlace2D: allocation failed");
+        free(glyphs);
+        free(out);
+        return;
+    }
+
+    rngSeed(&rng, 29);
+
+    checkPlace(&rng, glyphs, out);
+
+    ascii2_t head[O_PIPE_HEAD_BOT_LEN];
+
+    for (u32 i = 0; i < O_PIPE_HEAD_BOT_LEN; i++) {
+        head[i].xpos = asciiPosToFixed(o_asciiPipeHeadBot[i].pos.x);
+        head[i].ypos = asciiPosToFixed(o_asciiPipeHeadBot[i].pos.y);
+        head[i].color = asciiPaletteIndex(o_asciiPipeHeadBot[i].color);
+        head[i].charID = (Uint8) o_asciiPipeHeadBot[i].charID;
+        head[i].flags = ASCII_GLYPH_VISIBLE;
+        head[i].pad = 0;
+    }
+
+    // stress array all valid, glyphs near the edges partly off screen
+    randomPlaceGlyphs(&rng, glyphs, BENCH_PLACE_GLYPHS);
+
+    for (u32 i = 0; i < BENCH_PLACE_GLYPHS; i++) {
+        glyphs[i].charID = (Uint8) (33 + i % 94);
+        glyphs[i].flags = ASCII_GLYPH_VISIBLE;
+    }
+
+    u32 kernel = asciiPlaceGetKernel();
+
+    SDL_Log("ascii placement kernel: %s", asciiPlaceKernelName(kernel));
+
+    for (u32 k = 0; k < ASCII_PLACE_KERNELS; k++) {
+        if (asciiPlaceKernelSupported(k))
+            timePlace(k, iterations, head, glyphs, out);
+    }
+
+    asciiPlaceSetKernel(kernel);
+
+    free(glyphs);
+    free(out);
+}
+
+//
+//  3D pipeline, default camera must match 2D placement, sort must be back to front, culling must be complete
+//
+static ascii3_t randomGlyph3D(rng_t* rng, f32 x, f32 y, f32 z)
+{
+    ascii3_t glyph;
+
+    memset(&glyph, 0, sizeof(glyph));
+
+    glyph.xpos = x;
+    glyph.ypos = y;
+    glyph.zpos = z;
+    glyph.color = asciiPaletteIndex(g_bColors[rngNext(rng) % SDL_arraysize(g_bColors)]);
+    glyph.flags = ASCII_GLYPH_VISIBLE;
+    glyph.charID = 33 + rngNext(rng) % 94;
+
+    return glyph;
+}
+
+static void checkPlane3D(rng_t* rng, ascii3_t* glyphs)
+{
+    for (u32 i = 0; i < BENCH_3D_CHECK_GLYPHS; i++)
+        glyphs[i] = randomGlyph3D(rng, (f32) (rngNext(rng) % (WINDOW_WIDTH - 16)), (f32) (rngNext(rng) % (WINDOW_HEIGHT - 16)), 0.0f);
+
+    ascii3DBegin();
+    ascii3DSubmit(glyphs, BENCH_3D_CHECK_GLYPHS, 0.0f, 0.0f, 0.0f);
+
+    if (ascii3DSort() != BENCH_3D_CHECK_GLYPHS) {
+        benchFail("ascii3D: glyphs on z = 0 plane were culled");
+        return;
+    }
+
+    // equal depth keeps submission order
+    for (u32 i = 0; i < BENCH_3D_CHECK_GLYPHS; i++) {
+        const ascii3dglyph_t* g = ascii3DGetGlyph(i);
+
+        if (fabsf(g->xpos - glyphs[i].xpos) > 0.01f || fabsf(g->ypos - glyphs[i].ypos) > 0.01f ||
+            fabsf(g->scale - ASCII_RENDER_SCALE) > 0.0001f || g->charID != glyphs[i].charID)
+        {
+            benchFail("ascii3D: default camera does not match 2D placement");
+            return;
+        }
+    }
+}
+
+static void checkDepthOrder3D(rng_t* rng, ascii3_t* glyphs)
+{
+    for (u32 i = 0; i < BENCH_3D_CHECK_GLYPHS; i++) {
+        f32 x = WINDOW_WIDTH / 2.0f + (f32) (rngNext(rng) % 100) - 50.0f;
+        f32 y = WINDOW_HEIGHT / 2.0f + (f32) (rngNext(rng) % 100) - 50.0f;
+
+        glyphs[i] = randomGlyph3D(rng, x, y, (f32) (rngNext(rng) % 2200) - 200.0f);
+    }
+
+    ascii3DBegin();
+    ascii3DSubmit(glyphs, BENCH_3D_CHECK_GLYPHS, 0.0f, 0.0f, 0.0f);
+
+    u32 count = ascii3DSort();
+
+    if (count != BENCH_3D_CHECK_GLYPHS) {
+        benchFail("ascii3D: glyphs inside view volume were culled");
+        return;
+    }
+
+    for (u32 i = 1; i < count; i++) {
+        const ascii3dglyph_t* prev = ascii3DGetGlyph(i - 1);
+        const ascii3dglyph_t* cur = ascii3DGetGlyph(i);
+
+        if (prev->depth > cur->depth || prev->scale > cur->scale + 0.0001f) {
+            benchFail("ascii3D: glyphs not sorted back to front");
+            return;
+        }
+    }
+}
+
+static void checkCulling3D(rng_t* rng, ascii3_t* glyphs)
+{
+    asciicamera_t cam;
+
+    ascii3DGetCamera(&cam);
+
+    // behind camera, beyond far plane, left and below screen, invisible
+    for (u32 i = 0; i < BENCH_3D_CHECK_GLYPHS; i++) {
+        switch (i % 5) {
+            case 0: glyphs[i] = randomGlyph3D(rng, 640.0f, 360.0f, cam.pos.z - 10.0f); break;
+            case 1: glyphs[i] = randomGlyph3D(rng, 640.0f, 360.0f, cam.farZ + 10.0f); break;
+            case 2: glyphs[i] = randomGlyph3D(rng, -100.0f, 360.0f, 0.0f); break;
+            case 3: glyphs[i] = randomGlyph3D(rng, 640.0f, WINDOW_HEIGHT + 10.0f, 0.0f); break;
+            case 4: glyphs[i] = randomGlyph3D(rng, 640.0f, 360.0f, 0.0f); glyphs[i].flags = 0; break;
+        }
+    }
+
+    ascii3DBegin();
+    ascii3DSubmit(glyphs, BENCH_3D_CHECK_GLYPHS, 0.0f, 0.0f, 0.0f);
+
+    ascii3dstats_t stats;
+
+    if (ascii3DSort()) {
+        benchFail("ascii3D: glyphs outside view volume were not culled");
+        return;
+    }
+
+    ascii3DGetStats(&stats);
+
+    if (stats.submitted != BENCH_3D_CHECK_GLYPHS || stats.culled != BENCH_3D_CHECK_GLYPHS)
+        benchFail("ascii3D: culled count differs");
+
+    // turned around, glyphs on the z = 0 plane are behind the camera
+    for (u32 i = 0; i < BENCH_3D_CHECK_GLYPHS; i++)
+        glyphs[i] = randomGlyph3D(rng, 640.0f, 360.0f, 0.0f);
+
+    cam.yaw = SDL_PI_F;
+
+    ascii3DSetCamera(&cam);
+
+    ascii3DBegin();
+    ascii3DSubmit(glyphs, BENCH_3D_CHECK_GLYPHS, 0.0f, 0.0f, 0.0f);
+
+    if (ascii3DSort())
+        benchFail("ascii3D: glyphs behind rotated camera were not culled");
+
+    ascii3DDefaultCamera(&cam);
+    ascii3DSetCamera(&cam);
+}
+
+// project, cull and depth sort 100k glyphs in a volume in front of the default camera, drawing excluded
+void benchAscii3D(u32 scale)
+{
+    u32 iterations = 64 * scale;
+    asciicamera_t cam;
+    rng_t rng;
+
+    rAssert(iterations <= BENCH_MAX_SAMPLES);
+
+    ascii3_t* glyphs = (ascii3_t*) malloc(BENCH_3D_GLYPHS * sizeof(ascii3_t));
+
+    if (!glyphs) {
+        SDL_Log("Failed to allocate 3D benchmark glyphs");
+        return;
+    }
+
+    rngSeed(&rng, 23);
+
+    ascii3DDefaultCamera(&cam);
+    ascii3DSetCamera(&cam);
+
+    checkPlane3D(&rng, glyphs);
+    checkDepthOrder3D(&rng, glyphs);
+    checkCulling3D(&rng, glyphs);
+
+    // near glyphs left and right of the screen fall outside the frustum
+    for (u32 i = 0; i < BENCH_3D_GLYPHS; i++) {
+        f32 x = (f32) (rngNext(&rng) % (WINDOW_WIDTH * 3 / 2)) - WINDOW_WIDTH / 4.0f;
+        f32 y = (f32) (rngNext(&rng) % WINDOW_HEIGHT);
+
+        glyphs[i] = randomGlyph3D(&rng, x, y, (f32) (rngNext(&rng) % 4000));
+    }
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        ascii3DBegin();
+        ascii3DSubmit(glyphs, BENCH_3D_GLYPHS, 0.0f, 0.0f, (f32) (i & 7));
+        ascii3DSort();
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    ascii3dstats_t stats;
+
+    ascii3DGetStats(&stats);
+
+    SDL_Log("ascii 3D kernel: %s, %lu of %lu glyphs drawn, scratch %lu glyphs", ascii3DKernelName(), stats.drawn, stats.submitted, stats.capacity);
+
+    // ends the batch without drawing anything
+    ascii3DBegin();
+    ascii3DFlush();
+
+    free(glyphs);
+
+    benchReport("ascii3D.projectSort", "glyphs", iterations, BENCH_3D_GLYPHS);
+}
@@ -0,0 +1,869 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <main.h>
+#include <bench.h>
+#include <render.h>
+#include <ascii.h>
+#include <objects.h>
+#include <asciiplace.h>
+#include <profiler.h>
+#include <worldrender.h>
+#include <replay.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+#define BENCH_VERSION           1
+#define BENCH_MAX_RESULTS       64
+
+#define BENCH_GLYPHS            4096    // glyphs per renderBuf2D call
+#define BENCH_STRINGS           256     // strings per iteration
+#define BENCH_OBJECTS           16      // objects per iteration, must fit the ascii char buf
+#define BENCH_SNAPSHOTS         1024    // snapshots published per iteration
+#define BENCH_REPLAY_PATH       "flappy_bench.replay"
+#define BENCH_MESH_MAX_GLYPHS   (O_PIPE_HEAD_BOT_LEN + 32 * O_PIPE_SECTION_LEN)    // randomizePair heights need up to 27 sections
+
+// world state after one tick of the recorded run
+typedef struct replaytick_s {
+    f32 birdY;
+    u32 score;
+    u32 result;
+} replaytick_t;
+
+SDL_Renderer* g_renderer = NULL;
+
+const texinfo_t textures[3] = {
+    {"..\\resources\\bird.bmp", TEXTURE_BIRD, INTERPOLATION_NONE},
+    {"..\\resources\\pipe.bmp", TEXTURE_PIPE, INTERPOLATION_NONE},
+    {"..\\resources\\cloud.bmp", TEXTURE_CLOUD, INTERPOLATION_NONE}
+};
+
+benchresult_t g_bResults[BENCH_MAX_RESULTS];
+u32 g_bNumResults = 0;
+
+bool g_bFailed = 0;
+
+u64 g_bSamples[BENCH_MAX_SAMPLES];
+
+//
+//  Local functions
+//
+static int SDLCALL compareU64(const void* a, const void* b)
+{
+    u64 x = *(const u64*) a;
+    u64 y = *(const u64*) b;
+
+    return (x > y) - (x < y);
+}
+
+//
+//  Result collection, shared by all benchmark modules
+//
+benchresult_t* benchAddResult(const char* name, const char* unit)
+{
+    rAssert(g_bNumResults < BENCH_MAX_RESULTS);
+
+    benchresult_t* res = g_bResults + g_bNumResults++;
+
+    memset(res, 0, sizeof(benchresult_t));
+
+    res->name = name;
+    res->unit = unit;
+
+    return res;
+}
+
+// summarize iteration times in g_bSamples, each iteration processed itemsPerIter items
+void benchReport(const char* name, const char* unit, u32 iterations, u64 itemsPerIter)
+{
+    rAssert(iterations && iterations <= BENCH_MAX_SAMPLES);
+
+    benchresult_t* res = benchAddResult(name, unit);
+
+    for (u32 i = 0; i < iterations; i++)
+        res->totalNS += g_bSamples[i];
+
+    SDL_qsort(g_bSamples, iterations, sizeof(u64), compareU64);
+
+    res->count = itemsPerIter * iterations;
+    res->iterations = iterations;
+    res->avgNS = res->totalNS / iterations;
+    res->p50NS = g_bSamples[(iterations - 1) / 2];
+    res->p99NS = g_bSamples[(iterations - 1) * 99 / 100];
+
+    SDL_Log
+    (
+        "%-24s %12.0f %s/s, avg %.3f ms p99 %.3f ms per iteration",
+        name,
+        res->totalNS ? (f64) res->count * SDL_NS_PER_SECOND / res->totalNS : 0.0,
+        unit,
+        res->avgNS / 1e6,
+        res->p99NS / 1e6
+    );
+}
+
+void benchFail(const char* msg)
+{
+    SDL_Log("FAILED %s", msg);
+
+    g_bFailed = 1;
+}
+
+//
+//  Renderer benchmarks
+//
+// glyph submission and rasterization through renderBuf2D
+static void benchRenderBuf2D(u32 iterations)
+{
+    static ascii2_t glyphs[BENCH_GLYPHS];
+
+    rng_t rng;
+
+    rngSeed(&rng, 1);
+
+    for (u32 i = 0; i < BENCH_GLYPHS; i++) {
+        glyphs[i].xpos = asciiPosToFixed((f32) rngRange(&rng, 0, WINDOW_WIDTH - 16));
+        glyphs[i].ypos = asciiPosToFixed((f32) rngRange(&rng, 0, WINDOW_HEIGHT - 16));
+        glyphs[i].color = asciiPaletteIndex(i & 1 ? COLOR_L_GREEN : COLOR_WHITE);
+        glyphs[i].charID = (Uint8) rngRange(&rng, 33, 126);
+        glyphs[i].flags = ASCII_GLYPH_VISIBLE;
+        glyphs[i].pad = 0;
+    }
+
+    clearScreen(COLOR_BLACK);
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        renderBuf2D(glyphs, BENCH_GLYPHS, 0.0f, 0.0f);
+        renderFlush();
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    benchReport("renderBuf2D", "glyphs", iterations, BENCH_GLYPHS);
+}
+
+// formatted score strings, like the in game hud
+static void benchRenderStrFmt(u32 iterations)
+{
+    clearScreen(COLOR_BLACK);
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_STRINGS; k++)
+            renderStrColorFmt((k % 4) * 320, (k / 4) * 11, 0.25f, COLOR_WHITE, "Score: %5ld", i * BENCH_STRINGS + k);
+
+        renderFlush();
+        memFrameReset();
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    benchReport("renderStrColorFmt", "strings", iterations, BENCH_STRINGS);
+}
+
+// region of the offscreen target, for comparing two ways of drawing the same thing
+static SDL_Surface* readRegion(i32 xpos, i32 ypos, i32 width, i32 height)
+{
+    const SDL_Rect rect = {xpos, ypos, width, height};
+
+    renderFlush();
+
+    return SDL_RenderReadPixels(g_renderer, &rect);
+}
+
+static bool sameSurface(const SDL_Surface* a, const SDL_Surface* b)
+{
+    if (!a || !b || a->w != b->w || a->h != b->h || a->format != b->format)
+        return 0;
+
+    for (i32 y = 0; y < a->h; y++) {
+        if (memcmp((const u8*) a->pixels + y * a->pitch, (const u8*) b->pixels + y * b->pitch, a->w * SDL_BYTESPERPIXEL(a->format)))
+            return 0;
+    }
+
+    return 1;
+}
+
+// hud score formatted with vsnprintf and drawn glyph by glyph against renderFormatU64 and the text cache
+// score changes every 64 frames like passing a pipe, baked strings must match the glyph path pixel for pixel
+static void benchTextCache(u32 iterations)
+{
+    static const u64 values[] = {0, 7, 10, 99, 100, 999, 12345, 99999, 100000, 4294967295ull, 18446744073709551615ull};
+
+    char text[RENDER_U64_MAX_DIGITS + 8] = "Score: ";
+    char ref[RENDER_U64_MAX_DIGITS + 8];
+
+    for (u32 i = 0; i < SDL_arraysize(values); i++) {
+        for (u32 width = 0; width < 8; width += 5) {
+            SDL_snprintf(ref, sizeof(ref), "%*llu", (int) width, values[i]);
+
+            if (renderFormatU64(text + 7, values[i], width) != SDL_strlen(ref) || SDL_strcmp(text + 7, ref))
+                benchFail("renderFormatU64 differs from snprintf");
+        }
+    }
+
+    u64 frames = (u64) iterations * BENCH_STRINGS;
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_STRINGS; k++) {
+            renderStrColorFmt(23, 23, 0.25f, COLOR_WHITE, "Score: %5ld", (i * BENCH_STRINGS + k) / 64);
+            renderFlush();
+        }
+
+        memFrameReset();
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    benchReport("hudScoreFmt", "strings", iterations, BENCH_STRINGS);
+
+    renderstats_t before, after;
+
+    renderTextCacheClear();
+    renderGetStats(&before);
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_STRINGS; k++) {
+            (void) renderFormatU64(text + 7, (i * BENCH_STRINGS + k) / 64, 5);
+            renderStrCached(23, 23, 0.25f, COLOR_WHITE, text);
+            renderFlush();
+        }
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    renderGetStats(&after);
+
+    benchReport("hudScoreCached", "strings", iterations, BENCH_STRINGS);
+
+    u64 hits = after.textHits - before.textHits;
+    u64 misses = after.textMisses - before.textMisses;
+
+    SDL_Log("hudScoreCached: %llu hits, %llu misses, %llu evictions", hits, misses, after.textEvictions - before.textEvictions);
+
+    if (hits + misses != frames || misses != (frames + 63) / 64)
+        benchFail("text cache did not bake every score exactly once");
+
+    // baked and hit strings against the glyph path, at the sizes the game uses
+    static const f32 scales[] = {0.25f, 0.1875f, 0.5f, 1.0f};
+
+    for (u32 i = 0; i < SDL_arraysize(scales); i++) {
+        const i32 width = (i32) (12 * 64 * scales[i]) + 1;
+        const i32 height = (i32) (64 * scales[i]) + 1;
+
+        (void) renderFormatU64(text + 7, 1234 + i, 5);
+
+        clearScreen(COLOR_AZURE);
+        renderStrColor(23, 23, scales[i], COLOR_PURPLE, text);
+        SDL_Surface* glyphs = readRegion(23, 23, width, height);
+
+        clearScreen(COLOR_AZURE);
+        renderStrCached(23, 23, scales[i], COLOR_PURPLE, text);
+        SDL_Surface* baked = readRegion(23, 23, width, height);
+
+        clearScreen(COLOR_AZURE);
+        renderStrCached(23, 23, scales[i], COLOR_PURPLE, text);
+        SDL_Surface* hit = readRegion(23, 23, width, height);
+
+        if (!sameSurface(glyphs, baked) || !sameSurface(glyphs, hit))
+            benchFail("cached string differs from glyph by glyph drawing");
+
+        SDL_DestroySurface(glyphs);
+        SDL_DestroySurface(baked);
+        SDL_DestroySurface(hit);
+    }
+}
+
+// object creation from the game's templates, buffers are reset between iterations and reset is not timed
+static void benchObject2DIStruct(u32 iterations)
+{
+    static const ascii2info_t* templates[4] = {o_asciiBird, o_asciiPipeSection, o_asciiPipeHeadTop, o_asciiPipeHeadBot};
+    static const u32 lens[4] = {O_ASCII_BIRD_LEN, O_PIPE_SECTION_LEN, O_PIPE_HEAD_TOP_LEN, O_PIPE_HEAD_BOT_LEN};
+
+    for (u32 i = 0; i < iterations; i++) {
+        asciiResetAll();
+
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_OBJECTS; k++) {
+            if (!asciiObject2DIStruct(templates[k % 4], lens[k % 4]))
+                SDL_Log("Failed to create ascii object");
+        }
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    asciiResetAll();
+
+    benchReport("asciiObject2DIStruct", "objects", iterations, BENCH_OBJECTS);
+}
+
+// remove and recreate live objects, exercises the object pool and char buf slot reuse
+static void benchObjectChurn(u32 iterations)
+{
+    static const ascii2info_t* templates[4] = {o_asciiBird, o_asciiPipeSection, o_asciiPipeHeadTop, o_asciiPipeHeadBot};
+    static const u32 lens[4] = {O_ASCII_BIRD_LEN, O_PIPE_SECTION_LEN, O_PIPE_HEAD_TOP_LEN, O_PIPE_HEAD_BOT_LEN};
+
+    asciiobj_t* objects[BENCH_OBJECTS];
+
+    asciiResetAll();
+
+    for (u32 k = 0; k < BENCH_OBJECTS; k++)
+        objects[k] = asciiObject2DIStruct(templates[k % 4], lens[k % 4]);
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        // same template per slot, freed chars always fit again and nothing gets paged
+        for (u32 k = 0; k < BENCH_OBJECTS; k++) {
+            if (objects[k])
+                removeAsciiObject(objects[k]);
+
+            if (!(objects[k] = asciiObject2DIStruct(templates[k % 4], lens[k % 4])))
+                SDL_Log("Failed to create ascii object");
+        }
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    asciiResetAll();
+
+    benchReport("asciiObjectChurn", "objects", iterations, BENCH_OBJECTS);
+}
+
+// objects through the render queue, enough glyphs to spill past the static render buf every frame
+static void benchRenderQueue(u32 iterations)
+{
+    static const ascii2info_t* templates[4] = {o_asciiBird, o_asciiPipeSection, o_asciiPipeHeadTop, o_asciiPipeHeadBot};
+    static const u32 lens[4] = {O_ASCII_BIRD_LEN, O_PIPE_SECTION_LEN, O_PIPE_HEAD_TOP_LEN, O_PIPE_HEAD_BOT_LEN};
+
+    asciiobj_t* objects[BENCH_OBJECTS];
+    u32 glyphs = 0;
+
+    asciiResetAll();
+
+    for (u32 k = 0; k < BENCH_OBJECTS; k++) {
+        objects[k] = asciiObject2DIStruct(templates[k % 4], lens[k % 4]);
+
+        objects[k]->xpos = (f32) (k % 4) * 320.0f;
+        objects[k]->ypos = (f32) (k / 4) * 180.0f;
+
+        glyphs += lens[k % 4];
+    }
+
+    u32 repeats = BENCH_GLYPHS / glyphs + 1;
+
+    clearScreen(COLOR_BLACK);
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 r = 0; r < repeats; r++) {
+            for (u32 k = 0; k < BENCH_OBJECTS; k++)
+                renderAsciiObject2D(objects[k]);
+        }
+
+        asciiRender2D(COLOR_BLACK, 0, 0);
+        renderFlush();
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    asciiqueuestats_t stats;
+
+    asciiGetQueueStats(&stats);
+
+    SDL_Log
+    (
+        "render queue: peak %lu chars, %lu chunks, %llu bytes, %llu spills",
+        stats.peakChars,
+        stats.chunks,
+        stats.capacity,
+        stats.spills
+    );
+
+    asciiResetAll();
+
+    benchReport("asciiRenderQueue", "glyphs", iterations, (u64) repeats * glyphs);
+}
+
+// producer of benchSnapshots, all positions of snapshot n are n so a torn copy shows
+static int SDLCALL snapProducer(void* data)
+{
+    snapbuf_t* buf = (snapbuf_t*) data;
+
+    for (u64 n = 1; n <= BENCH_SNAPSHOTS; n++) {
+        worldsnap_t* snap = snapBackSlot(buf);
+
+        for (u32 i = 0; i < WORLD_MAX_SPRITES; i++) {
+            snap->sprites[i].xpos = (f32) n;
+            snap->sprites[i].prevx = (f32) n;
+        }
+
+        snap->ticks = n;
+        snap->seq = n;
+
+        snapPublish(buf);
+    }
+
+    return 0;
+}
+
+// simulation to render hand off, consumer polls while a thread publishes, never waits and must never see a torn or older snapshot
+static void benchSnapshots(u32 iterations)
+{
+    static snapbuf_t buf;
+
+    bool failed = 0;
+    u64 seen = 0;
+
+    for (u32 i = 0; i < iterations; i++) {
+        snapInit(&buf);
+
+        u64 start = SDL_GetTicksNS();
+        u64 last = 0;
+
+        SDL_Thread* producer = SDL_CreateThread(snapProducer, "benchsnap", &buf);
+
+        if (!producer) {
+            SDL_Log("Failed to create thread: %s", SDL_GetError());
+            benchFail("snapshot producer thread");
+            return;
+        }
+
+        while (last < BENCH_SNAPSHOTS) {
+            const worldsnap_t* snap = snapLatest(&buf);
+
+            if (snap->seq < last || snap->ticks != snap->seq)
+                failed = 1;
+
+            for (u32 k = 0; k < WORLD_MAX_SPRITES; k++) {
+                if (snap->sprites[k].xpos != (f32) snap->seq || snap->sprites[k].prevx != (f32) snap->seq)
+                    failed = 1;
+            }
+
+            if (snap->seq != last)
+                seen++;
+
+            last = snap->seq;
+        }
+
+        SDL_WaitThread(producer, NULL);
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    benchReport("snapshotPublish", "snapshots", iterations, BENCH_SNAPSHOTS);
+
+    SDL_Log("snapshotPublish: consumer picked up %.1f%% of snapshots", 100.0 * seen / ((f64) iterations * BENCH_SNAPSHOTS));
+
+    if (failed)
+        benchFail("snapshot triple buffer handed out a torn or older snapshot");
+}
+
+// flap when falling below the middle of the next gap
+static void scriptedInput(void)
+{
+    sprite_t* bird = getBird(&g_world);
+    pipepair_t* next = NULL;
+
+    for (u8 i = 0; i < g_world.pipesIdx; i++) {
+        pipepair_t* pair = g_world.pipes + i;
+
+        if (pair->top->xpos + pair->top->width < bird->xpos)
+            continue;
+
+        if (!next || pair->top->xpos < next->top->xpos)
+            next = pair;
+    }
+
+    f32 center = next ? (next->top->ypos + next->top->height + next->bot->ypos) / 2 : WINDOW_HEIGHT / 2;
+
+    if (bird->ypos + bird->height / 2 > center + 20.0f && g_world.birdSpeed > 0.0f)
+        inputUpdraft();
+}
+
+// record a scripted run, play it back with a fast forward to the middle, every tick must come out the same
+static void checkReplay(u32 ticks)
+{
+    replaytick_t* trace = (replaytick_t*) malloc((ticks + 1) * sizeof(replaytick_t));
+    u64 tickNS = SDL_NS_PER_SECOND / getTickRate();
+    u64 base;
+    u32 games = 0;
+
+    if (!trace) {
+        benchFail("replay: allocation failed");
+        return;
+    }
+
+    setGodMode(0);
+
+    if (!replayStartRecording(BENCH_REPLAY_PATH, getTickRate(), 0)) {
+        benchFail("replay: recording could not be started");
+        free(trace);
+        return;
+    }
+
+    // playback starts with world tick 0 like a fresh process, so does the recording
+    resetWorld(&g_world);
+    initWorldSeed(1);
+
+    base = getTotalTicks();
+
+    while (getTotalTicks() - base < ticks) {
+        scriptedInput();
+
+        // god mode and a couple of games in one log
+        if ((getTotalTicks() - base) % 1500 == 1000)
+            toggleGodMode();
+
+        u32 result = simulateWorld(tickNS);
+        replaytick_t* t = trace + (getTotalTicks() - base);
+
+        t->birdY = getBird(&g_world)->ypos;
+        t->score = g_world.score;
+        t->result = result;
+
+        if (result != GAME_CONTINUE)
+            initWorldSeed(++games + 1);
+    }
+
+    replayStop();
+
+    // once from the start, once fast forwarded to the middle
+    for (u32 pass = 0; pass < 2; pass++) {
+        u32 tickRate;
+        bool godMode;
+
+        if (!replayStartPlayback(BENCH_REPLAY_PATH, &tickRate, &godMode)) {
+            benchFail("replay: playback could not be started");
+            break;
+        }
+
+        setGodMode(godMode);
+        resetWorld(&g_world);
+
+        base = getTotalTicks();
+
+        replaySetFastForward(pass ? base + ticks / 2 : 0);
+
+        // fast forward steps many ticks per call, those are only compared where it stops
+        for (u64 n = 0, prev = 0; n < ticks; prev = n) {
+            bool ff = replayFastForwardLeft(getTotalTicks()) != 0;
+            u32 result = simulateWorld(tickNS);
+
+            n = getTotalTicks() - base;
+
+            // one tick per tick interval, otherwise ticks in between would go unchecked
+            if (ff ? n <= prev || n > ticks : n != prev + 1) {
+                SDL_Log("replay: pass %lu stepped from tick %llu to %llu in one tick interval", pass, prev, n);
+                benchFail("replay: playback did not step one tick per tick interval");
+                break;
+            }
+
+            const replaytick_t* t = trace + n;
+
+            if (getBird(&g_world)->ypos != t->birdY || g_world.score != t->score || result != t->result) {
+                SDL_Log("replay: pass %lu tick %llu differs, bird y %.3f score %lu result %lu, recorded %.3f %lu %lu",
+                    pass, n, getBird(&g_world)->ypos, g_world.score, result, t->birdY, t->score, t->result);
+                benchFail("replay: playback differs from recorded run");
+                break;
+            }
+        }
+
+        replayStop();
+    }
+
+    if (!games)
+        benchFail("replay: recorded run did not end a game, resets were not compared");
+
+    SDL_RemovePath(BENCH_REPLAY_PATH);
+
+    free(trace);
+}
+
+// pipe column meshes against the per section loop renderPipes drew them with, placed glyphs must be the same
+static void checkPipeMeshes(void)
+{
+    static asciiplaced_t mesh[BENCH_MESH_MAX_GLYPHS];
+    static asciiplaced_t ref[BENCH_MESH_MAX_GLYPHS];
+
+    // columns partly off both edges, glyphs are culled one by one in placement
+    const f32 xposList[] = {-100.5f, -37.25f, 0.0f, 412.75f, 1250.5f};
+
+    // first drawn frame of a new game builds the ascii pipe parts
+    initWorldSeed(1);
+    (void) updateWorld(SDL_MS_TO_NS(RENDER_FRAMETIME));
+    presentScreen();
+
+    u32 columns = 0;
+
+    // quarter px steps over the heights randomizePair picks, every sum stays exact in float
+    for (u32 hanging = 0; hanging < 2; hanging++) {
+        f32 first = hanging ? 80.0f : WINDOW_HEIGHT / 2;
+        f32 last = hanging ? 470.0f : WINDOW_HEIGHT - 70;
+
+        for (f32 y = first; y <= last; y += 2.25f) {
+            f32 xpos = xposList[columns++ % SDL_arraysize(xposList)];
+            i32 sections;
+            u32 count = 0;
+            asciiobj_t* column;
+
+            // y is the lower end of hanging pipes, the top of standing ones
+            if (hanging) {
+                sections = (i32) roundf((y - 126.0f) / 16) + 5;
+                column = getPipeMesh(1, sections);
+
+                count += asciiPlace2D(ref, g_wAsciiPipeHeadBot->data.ascii2, g_wAsciiPipeHeadBot->len, xpos, y - 48.0f);
+
+                g_wAsciiPipeSection->ypos = y - 121.0f;
+
+                for (i32 k = 0; k < sections; k++) {
+                    g_wAsciiPipeSection->ypos -= 16.0f;
+                    count += asciiPlace2D(ref + count, g_wAsciiPipeSection->data.ascii2, g_wAsciiPipeSection->len, xpos, g_wAsciiPipeSection->ypos);
+                }
+            } else {
+                sections = (i32) roundf((WINDOW_HEIGHT - y) / 16) - 3;
+                column = getPipeMesh(0, sections);
+
+                count += asciiPlace2D(ref, g_wAsciiPipeHeadTop->data.ascii2, g_wAsciiPipeHeadTop->len, xpos, y);
+
+                g_wAsciiPipeSection->ypos = y;
+
+                for (i32 k = 0; k < sections; k++) {
+                    count += asciiPlace2D(ref + count, g_wAsciiPipeSection->data.ascii2, g_wAsciiPipeSection->len, xpos, g_wAsciiPipeSection->ypos);
+                    g_wAsciiPipeSection->ypos += 16.0f;
+                }
+            }
+
+            if (!column || column->len > BENCH_MESH_MAX_GLYPHS) {
+                benchFail("pipe mesh: column allocation failed");
+                return;
+            }
+
+            if (asciiPlace2D(mesh, column->data.ascii2, column->len, xpos, y) != count || memcmp(mesh, ref, count * sizeof(asciiplaced_t))) {
+                SDL_Log("pipe mesh: %s column with %ld sections at %.2f, %.2f differs", hanging ? "hanging" : "standing", sections, xpos, y);
+                benchFail("pipe mesh: placed glyphs differ from per section loop");
+                return;
+            }
+        }
+    }
+}
+
+// full frames of a scripted game at the fallback frame interval, per zone stats come from the profiler
+static void benchFrames(u32 frames, bool ascii)
+{
+    static const char* zoneNames[2][PROF_MAX_ZONES] = {
+        {"frame.updateWorld", "frame.renderClouds", "frame.renderPipes", "frame.renderBird", "frame.renderBuf2D", "frame.present"},
+        {"ascii.updateWorld", "ascii.renderClouds", "ascii.renderPipes", "ascii.renderBird", "ascii.renderBuf2D", "ascii.present"}
+    };
+
+    if (ascii)
+        toggleAscii();
+
+    initWorldSeed(1);
+    setGodMode(1);
+    initProfiler();
+    renderResetStats();
+
+    for (u32 i = 0; i < frames; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        profFrame();
+
+        scriptedInput();
+
+        (void) updateWorld(SDL_MS_TO_NS(RENDER_FRAMETIME));
+
+        presentScreen();
+
+        memFrameReset();
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    profFrame();
+
+    benchReport(ascii ? "frame_ascii" : "frame", "frames", frames, 1);
+
+    renderstats_t rstats;
+
+    renderGetStats(&rstats);
+
+    if (rstats.frames) {
+        SDL_Log
+        (
+            "%s: %.1f commands, %.1f draw calls (%.1f immediate), %.1f state changes (%.1f immediate) per frame",
+            ascii ? "frame_ascii" : "frame",
+            (f64) rstats.commands / rstats.frames,
+            (f64) rstats.drawCalls / rstats.frames,
+            (f64) rstats.immediateDrawCalls / rstats.frames,
+            (f64) rstats.stateChanges / rstats.frames,
+            (f64) rstats.immediateStateChanges / rstats.frames
+        );
+    }
+
+    profstats_t stats;
+
+    for (u32 i = 0; i < PROF_MAX_ZONES; i++) {
+        profGetZoneStats(i, &stats);
+
+        benchresult_t* res = benchAddResult(zoneNames[ascii][i], "frames");
+
+        res->count = stats.frames;
+        res->iterations = stats.frames;
+        res->totalNS = stats.avg * stats.frames;
+        res->avgNS = stats.avg;
+        res->p50NS = stats.p50;
+        res->p99NS = stats.p99;
+    }
+
+    if (ascii)
+        toggleAscii();
+}
+
+static bool writeJson(FILE* out, bool blankAssets)
+{
+    fprintf(out, "{\n");
+    fprintf(out, "  \"bench\": \"flappy_bench\",\n");
+    fprintf(out, "  \"version\": %d,\n", BENCH_VERSION);
+    fprintf(out, "  \"renderer\": \"%s\",\n", SDL_GetRendererName(g_renderer));
+    fprintf(out, "  \"assets\": \"%s\",\n", blankAssets ? "blank" : "resources");
+    fprintf(out, "  \"results\": [\n");
+
+    for (u32 i = 0; i < g_bNumResults; i++) {
+        benchresult_t* res = g_bResults + i;
+
+        fprintf
+        (
+            out,
+            "    {\"name\": \"%s\", \"unit\": \"%s\", \"count\": %llu, \"iterations\": %llu, \"total_ns\": %llu, "
+            "\"per_sec\": %.1f, \"avg_ns\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu}%s\n",
+            res->name,
+            res->unit,
+            res->count,
+            res->iterations,
+            res->totalNS,
+            res->totalNS ? (f64) res->count * SDL_NS_PER_SECOND / res->totalNS : 0.0,
+            res->avgNS,
+            res->p50NS,
+            res->p99NS,
+            i + 1 < g_bNumResults ? "," : ""
+        );
+    }
+
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+
+    return !ferror(out);
+}
+
+//
+//  Renderer and ascii engine benchmarks on an offscreen software renderer, no window or gpu needed
+//
+//  usage: flappy_bench [output.json] [scale]
+//
+//  results are written as json to output.json or stdout, scale multiplies iteration counts
+//
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : NULL;
+    u32 scale = argc > 2 ? strtoul(argv[2], NULL, 10) : 1;
+
+    if (!scale || scale > 8) {
+        SDL_Log("usage: flappy_bench [output.json] [scale 1-8]");
+        return 1;
+    }
+
+    if (!SDL_Init(0)) {
+        SDL_Log("Failed to initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+
+    // before anything else allocates, memtrack.threads resets memtrack to test lazy initialization
+    benchMemtrack(scale);
+    benchMemtrackThreads(scale);
+
+    SDL_Surface* target = SDL_CreateSurface(WINDOW_WIDTH, WINDOW_HEIGHT, SDL_PIXELFORMAT_RGBA32);
+
+    if (!target || !(g_renderer = SDL_CreateSoftwareRenderer(target))) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    initRenderer();
+
+    initAscii(ASCII_RENDER_MODE_2D);
+
+    bool blankAssets = 0;
+
+    // measure with real assets when available, blank ones keep the benchmark runnable anywhere
+    if (!loadTextures(textures, 3) || !loadCharTextures("..\\resources\\ascii\\pressstart\\", 95)) {
+        SDL_Log("Resources not found, using blank textures");
+
+        cleanupRenderer();
+
+        blankAssets = 1;
+
+        if (!loadBlankTexture(16, 12, TEXTURE_BIRD) ||
+            !loadBlankTexture(20, 125, TEXTURE_PIPE) ||
+            !loadBlankTexture(64, 32, TEXTURE_CLOUD) ||
+            !loadBlankCharTextures(95))
+        {
+            return 1;
+        }
+    }
+
+    initProfiler();
+
+    benchAsciiKernels(scale);
+    benchAsciiPlace(scale);
+    benchAscii3D(scale);
+    checkWorldBatch(scale);
+
+    benchRenderBuf2D(100 * scale);
+    benchRenderStrFmt(200 * scale);
+    benchTextCache(16 * scale);
+    benchObject2DIStruct(BENCH_MAX_SAMPLES / 8 * scale);
+    benchObjectChurn(BENCH_MAX_SAMPLES / 8 * scale);
+    benchRenderQueue(100 * scale);
+    benchSnapshots(64 * scale);
+    checkReplay(20000 * scale);
+    checkPipeMeshes();
+    benchFrames(500 * scale, 0);
+    benchFrames(500 * scale, 1);
+
+    FILE* out = path ? fopen(path, "w") : stdout;
+
+    if (!out) {
+        SDL_Log("Failed to open %s", path);
+        return 1;
+    }
+
+    bool ok = writeJson(out, blankAssets);
+
+    if (path)
+        ok = !fclose(out) && ok;
+
+    cleanupAscii();
+    cleanupRenderer();
+
+    memFrameDestroy();
+
+    SDL_DestroyRenderer(g_renderer);
+    SDL_DestroySurface(target);
+
+    SDL_Quit();
+
+    return ok && !g_bFailed ? 0 : 1;
+}
\ No newline at end of file
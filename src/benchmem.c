@@ -0,0 +1,383 @@
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <bench.h>
+#include <rng.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+#define BENCH_MEM_ROUNDS_PER_ITER   64      // free + alloc pairs per timed iteration
+#define BENCH_MEM_MAX_LIVE          4096
+
+#define BENCH_MEM_THREADS           8
+#define BENCH_MEM_THREAD_OPS        4096    // operations per thread and iteration
+#define BENCH_MEM_THREAD_SLOTS      64      // live blocks per thread
+#define BENCH_MEM_EXCHANGE          16      // slots for handing blocks to other threads
+
+//
+//  Linear scan bookkeeping as memtrack did it before hashing, reference for comparison
+//
+typedef struct linblock_s {
+    void* ptr;
+    size_t size;
+} linblock_t;
+
+linblock_t* g_linBuf = NULL;
+size_t g_linBufSize = 0;
+
+void** g_linFreeBuf = NULL;
+size_t g_linFreeSize = 0;
+size_t g_linFreeIdx = 0;
+
+static void linInit(void)
+{
+    g_linBufSize = MTRACK_BUF_SIZE;
+    g_linBuf = (linblock_t*) calloc(g_linBufSize, sizeof(linblock_t));
+
+    g_linFreeSize = MTRACK_BUF_SIZE;
+    g_linFreeIdx = 0;
+    g_linFreeBuf = (void**) calloc(g_linFreeSize, sizeof(void*));
+}
+
+static void linCleanup(void)
+{
+    free(g_linBuf);
+    free(g_linFreeBuf);
+
+    g_linBuf = NULL;
+    g_linFreeBuf = NULL;
+}
+
+static void* linAlloc(size_t size)
+{
+    void* ptr = malloc(size);
+
+    for (size_t i = 0; i < g_linBufSize; i++) {
+        if (!g_linBuf[i].ptr) {
+            g_linBuf[i].ptr = ptr;
+            g_linBuf[i].size = size;
+            return ptr;
+        }
+    }
+
+    g_linBuf = (linblock_t*) realloc(g_linBuf, (g_linBufSize + 32) * sizeof(linblock_t));
+
+    memset(g_linBuf + g_linBufSize, 0, 32 * sizeof(linblock_t));
+
+    g_linBuf[g_linBufSize].ptr = ptr;
+    g_linBuf[g_linBufSize].size = size;
+    g_linBufSize += 32;
+
+    return ptr;
+}
+
+static void linFree(void* ptr)
+{
+    for (size_t i = 0; i < g_linBufSize; i++) {
+        if (g_linBuf[i].ptr == ptr) {
+            g_linBuf[i].ptr = NULL;
+            g_linBuf[i].size = 0;
+
+            if (g_linFreeIdx >= g_linFreeSize) {
+                g_linFreeSize += 32;
+                g_linFreeBuf = (void**) realloc(g_linFreeBuf, g_linFreeSize * sizeof(void*));
+            }
+
+            g_linFreeBuf[g_linFreeIdx++] = ptr;
+
+            free(ptr);
+
+            return;
+        }
+    }
+}
+
+// blocks parked here are freed or reallocated by whichever thread picks them up
+void* g_bExchange[BENCH_MEM_EXCHANGE];
+
+typedef struct memthread_s {
+    u32 seed;
+    SDL_AtomicInt* failed;
+    SDL_AtomicInt* start;   // first use threads spin on it so they allocate at the same time
+} memthread_t;
+
+//
+//  Allocation churn with a fixed number of live blocks, same trace for both implementations
+//
+static void churn(const char* name, u32 live, u32 iterations, const u32* victims, const u32* sizes, bool linear)
+{
+    static void* blocks[BENCH_MEM_MAX_LIVE];
+
+    rAssert(live <= BENCH_MEM_MAX_LIVE);
+
+    if (linear)
+        linInit();
+
+    for (u32 i = 0; i < live; i++) {
+        if (linear)
+            blocks[i] = linAlloc(sizes[i]);
+        else
+            blocks[i] = memAlloc(sizes[i]);
+    }
+
+    u32 round = 0;
+
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_MEM_ROUNDS_PER_ITER; k++, round++) {
+            u32 v = victims[round];
+
+            if (linear) {
+                linFree(blocks[v]);
+                blocks[v] = linAlloc(sizes[round]);
+            } else {
+                memFree(blocks[v]);
+                blocks[v] = memAlloc(sizes[round]);
+            }
+        }
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    for (u32 i = 0; i < live; i++) {
+        if (linear)
+            linFree(blocks[i]);
+        else
+            memFree(blocks[i]);
+    }
+
+    if (linear)
+        linCleanup();
+
+    benchReport(name, "ops", iterations, BENCH_MEM_ROUNDS_PER_ITER * 2);
+}
+
+// memtrack bookkeeping cost against live block count, hashed vs old linear scans
+void benchMemtrack(u32 scale)
+{
+    static const u32 liveCounts[3] = {16, 256, BENCH_MEM_MAX_LIVE};
+    static char names[3][2][48];
+
+    u32 iterations = 256 * scale;
+    u32 rounds = iterations * BENCH_MEM_ROUNDS_PER_ITER;
+
+    rAssert(iterations <= BENCH_MAX_SAMPLES);
+
+    u32* victims = (u32*) malloc(rounds * sizeof(u32));
+    u32* sizes = (u32*) malloc(rounds * sizeof(u32));
+
+    if (!victims || !sizes) {
+        SDL_Log("Failed to allocate memtrack benchmark trace");
+        free(victims);
+        free(sizes);
+        return;
+    }
+
+    // staging builds run normal law, debug law also formats a string per free
+    memChLaw(MTRACK_NORMAL_LAW);
+
+    for (u32 c = 0; c < 3; c++) {
+        rng_t rng;
+
+        rngSeed(&rng, c + 1);
+
+        for (u32 i = 0; i < rounds; i++) {
+            victims[i] = (u32) (((u64) rngNext(&rng) * liveCounts[c]) >> 32);
+            sizes[i] = 16 + (u32) (((u64) rngNext(&rng) * 240) >> 32);
+        }
+
+        SDL_snprintf(names[c][0], sizeof(names[c][0]), "memtrack.hash.live%lu", liveCounts[c]);
+        SDL_snprintf(names[c][1], sizeof(names[c][1]), "memtrack.linear.live%lu", liveCounts[c]);
+
+        churn(names[c][0], liveCounts[c], iterations, victims, sizes, 0);
+        churn(names[c][1], liveCounts[c], iterations, victims, sizes, 1);
+    }
+
+#ifdef MTRACK_DEBUG
+    memChLaw(MTRACK_DEBUG_LAW);
+#endif
+
+    free(victims);
+    free(sizes);
+}
+
+// random alloc / realloc / free from one thread, about a quarter of the blocks change threads
+static int SDLCALL memThread(void* data)
+{
+    memthread_t* args = (memthread_t*) data;
+    void* blocks[BENCH_MEM_THREAD_SLOTS] = {0};
+    rng_t rng;
+
+    rngSeed(&rng, args->seed);
+
+    for (u32 i = 0; i < BENCH_MEM_THREAD_OPS; i++) {
+        Uint32 r = rngNext(&rng);
+        u32 slot = r % BENCH_MEM_THREAD_SLOTS;
+        u32 size = 16 + (r >> 8) % 240;
+
+        if (!blocks[slot]) {
+            blocks[slot] = memAlloc(size);
+
+            if (!blocks[slot])
+                SDL_AddAtomicInt(args->failed, 1);
+
+            continue;
+        }
+
+        switch ((r >> 6) & 3) {
+            case 0:
+            case 1:
+                memFree(blocks[slot]);
+                blocks[slot] = NULL;
+                break;
+
+            case 2: {
+                void* tmp = memRealloc(blocks[slot], 256 + (r >> 16) % 1024);
+
+                if (tmp)
+                    blocks[slot] = tmp;
+                else
+                    SDL_AddAtomicInt(args->failed, 1);
+
+                break;
+            }
+
+            case 3:
+                blocks[slot] = SDL_SetAtomicPointer(&g_bExchange[(r >> 16) % BENCH_MEM_EXCHANGE], blocks[slot]);
+                break;
+        }
+    }
+
+    for (u32 i = 0; i < BENCH_MEM_THREAD_SLOTS; i++)
+        memFree(blocks[i]);
+
+    return 0;
+}
+
+// first allocation of the process, memtrack initializes lazily in whichever thread gets there first
+static int SDLCALL firstUseThread(void* data)
+{
+    memthread_t* args = (memthread_t*) data;
+    void* blocks[BENCH_MEM_THREAD_SLOTS];
+
+    while (!SDL_GetAtomicInt(args->start))
+        ;
+
+    for (u32 i = 0; i < BENCH_MEM_THREAD_SLOTS; i++) {
+        blocks[i] = memAlloc(16 + (args->seed + i) % 240);
+
+        if (!blocks[i])
+            SDL_AddAtomicInt(args->failed, 1);
+    }
+
+    for (u32 i = 0; i < BENCH_MEM_THREAD_SLOTS; i++)
+        memFree(blocks[i]);
+
+    return 0;
+}
+
+// threads race for lazy initialization, memtrack is reset to uninitialized before every round
+// a block tracked before the tables were visible would leave g_memAllocated off after its free
+static void firstUse(u32 rounds, SDL_AtomicInt* failed)
+{
+    SDL_Thread* threads[BENCH_MEM_THREADS];
+    memthread_t args[BENCH_MEM_THREADS];
+    SDL_AtomicInt start;
+
+    // cleanup frees every tracked block, nothing else may be allocated yet
+    if (g_memAllocated) {
+        benchFail("memtrack.firstuse: must run before anything is allocated");
+        return;
+    }
+
+    for (u32 i = 0; i < rounds; i++) {
+        memCleanup();
+
+        SDL_SetAtomicInt(&start, 0);
+
+        for (u32 k = 0; k < BENCH_MEM_THREADS; k++) {
+            args[k].seed = i * BENCH_MEM_THREADS + k;
+            args[k].failed = failed;
+            args[k].start = &start;
+
+            if (!(threads[k] = SDL_CreateThread(firstUseThread, "benchmem", args + k))) {
+                SDL_Log("Failed to create thread: %s", SDL_GetError());
+                SDL_AddAtomicInt(failed, 1);
+            }
+        }
+
+        SDL_SetAtomicInt(&start, 1);
+
+        for (u32 k = 0; k < BENCH_MEM_THREADS; k++) {
+            if (threads[k])
+                SDL_WaitThread(threads[k], NULL);
+        }
+
+        if (g_memAllocated) {
+            benchFail("memtrack.firstuse: blocks allocated during lazy initialization were not tracked");
+            return;
+        }
+    }
+}
+
+// memtrack from many threads at once, blocks are freed and reallocated by threads that did not allocate them
+void benchMemtrackThreads(u32 scale)
+{
+    u32 iterations = 16 * scale;
+
+    SDL_Thread* threads[BENCH_MEM_THREADS];
+    memthread_t args[BENCH_MEM_THREADS];
+    SDL_AtomicInt failed;
+
+    SDL_SetAtomicInt(&failed, 0);
+
+    firstUse(16 * scale, &failed);
+
+    memChLaw(MTRACK_NORMAL_LAW);
+
+    size_t baseline = g_memAllocated;
+
+    // threads exit every iteration, so records of exited threads get adopted by new ones
+    for (u32 i = 0; i < iterations; i++) {
+        u64 start = SDL_GetTicksNS();
+
+        for (u32 k = 0; k < BENCH_MEM_THREADS; k++) {
+            args[k].seed = i * BENCH_MEM_THREADS + k + 1;
+            args[k].failed = &failed;
+            args[k].start = NULL;
+
+            if (!(threads[k] = SDL_CreateThread(memThread, "benchmem", args + k))) {
+                SDL_Log("Failed to create thread: %s", SDL_GetError());
+                SDL_AddAtomicInt(&failed, 1);
+            }
+        }
+
+        for (u32 k = 0; k < BENCH_MEM_THREADS; k++) {
+            if (threads[k])
+                SDL_WaitThread(threads[k], NULL);
+        }
+
+        g_bSamples[i] = SDL_GetTicksNS() - start;
+    }
+
+    for (u32 i = 0; i < BENCH_MEM_EXCHANGE; i++) {
+        memFree(g_bExchange[i]);
+        g_bExchange[i] = NULL;
+    }
+
+    memReport();
+
+    if (SDL_GetAtomicInt(&failed))
+        benchFail("memtrack.threads: allocation failed");
+
+    if (g_memAllocated != baseline)
+        benchFail("memtrack.threads: allocated bytes did not return to baseline");
+
+#ifdef MTRACK_DEBUG
+    memChLaw(MTRACK_DEBUG_LAW);
+#endif
+
+    benchReport("memtrack.threads8", "ops", iterations, BENCH_MEM_THREADS * BENCH_MEM_THREAD_OPS);
+}
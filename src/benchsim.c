@@ -0,0 +1,86 @@
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <bench.h>
+#include <sim.h>
+#include <worldbatch.h>
+#include <rng.h>
+#include <debug/rdebug.h>
+
+#define BENCH_SIM_TICKS         4096    // ticks compared per game seed
+#define BENCH_SIM_TICKRATE      120
+
+// scripted agent from flappy_sim with random extra flaps, so games pass pipes and crash into them
+static u8 checkPolicy(const simobs_t* obs, rng_t* rng)
+{
+    f32 center = (obs->gapTop + obs->gapBot) / 2;
+
+    if (obs->birdY + 24.0f > center + 20.0f && obs->birdSpeed > 0.0f)
+        return SIM_ACTION_FLAP;
+
+    return (rngNext(rng) & 31) ? SIM_ACTION_NONE : SIM_ACTION_FLAP;
+}
+
+// batch kernels against stepWorld, lane 0 of a full vector block must play the same game as simStep
+void checkWorldBatch(u32 scale)
+{
+    u32 seeds = 8 * scale;
+
+    sim_t* sim = simCreate(BENCH_SIM_TICKRATE, 1);
+    worldbatch_t* batch = wbatchCreate(WBATCH_LANES, BENCH_SIM_TICKRATE, 1);
+
+    if (!sim || !batch) {
+        benchFail("wbatchStep: allocation failed");
+        simDestroy(sim);
+        wbatchDestroy(batch);
+        return;
+    }
+
+    u8 actions[WBATCH_LANES];
+    u64 episodes = 0;
+    bool match = 1;
+
+    for (u32 s = 0; s < seeds && match; s++) {
+        rng_t rng;
+        simobs_t obs;
+
+        // lane 0 draws from the stream rngSeed makes from the seed itself, same as seedWorld
+        simSeed(sim, s + 1);
+        wbatchRestart(batch, WBATCH_LANES, s + 1);
+
+        rngSeed(&rng, ~(u64) s);
+
+        for (u32 t = 0; t < BENCH_SIM_TICKS; t++) {
+            simObserve(sim, &obs);
+
+            // other lanes get the same actions, they only have to fill the vector
+            memset(actions, checkPolicy(&obs, &rng), sizeof(actions));
+
+            bool done = simStep(sim, actions[0]);
+
+            wbatchStep(batch, actions);
+
+            simObserve(sim, &obs);
+
+            if (obs.birdY != batch->birdY[0] || obs.score != batch->score[0] || done != (batch->done[0] != 0)) {
+                SDL_Log("wbatchStep (%s) lane 0 differs from simStep: seed %lu tick %lu", wbatchKernelName(), s + 1, t);
+                match = 0;
+                break;
+            }
+
+            // batch resets a crashed env on its next step, pipes continue the rng stream in both
+            if (done) {
+                simReset(sim);
+                episodes++;
+            }
+        }
+    }
+
+    if (!match)
+        benchFail("wbatchStep: lane 0 differs from simStep");
+    else if (!episodes)
+        benchFail("wbatchStep: no game ended, crash and reset were not compared");
+
+    simDestroy(sim);
+    wbatchDestroy(batch);
+}
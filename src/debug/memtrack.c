@@ -1,25 +1,79 @@
 #include <stdio.h>
 #include <string.h>
+#include <SDL3/SDL.h>
 
 #include <debug/memtrack.h>
 
+// Atomic counter helpers, g_memAllocated is updated from any thread without locking
+#if defined _MSC_VER && !defined __clang__
+    #include <intrin.h>
+
+    #ifdef _WIN64
+        #define __atomicAdd( p, v ) _InterlockedExchangeAdd64((volatile long long*) (p), (long long) (v))
+    #else
+        #define __atomicAdd( p, v ) _InterlockedExchangeAdd((volatile long*) (p), (long) (v))
+    #endif
+
+    #define __atomicLoad( p ) (*(volatile size_t*) (p))
+#else
+    #define __atomicAdd( p, v ) __atomic_fetch_add(p, (size_t) (v), __ATOMIC_RELAXED)
+    #define __atomicLoad( p ) __atomic_load_n(p, __ATOMIC_RELAXED)
+#endif
+
+#define __atomicSub( p, v ) __atomicAdd(p, (size_t) 0 - (size_t) (v))
+
+//
+//  Local types
+//
+typedef struct mrecord_s mrecord_t;
+
+// Allocation record of one thread, blocks are only inserted by the owning thread
+// Lock is uncontended unless another thread frees one of the blocks or records are merged
+struct mrecord_s {
+    SDL_SpinLock lock;
+
+    // Live blocks, open addressing hash table with linear probing, size is a power of 2
+    mblock_t* buf;
+    size_t bufSize;
+    size_t bufCount;
+
+    // Recently freed pointers, ring buffer of MTRACK_FREE_SET_SIZE entries
+    void** freeBuf;
+    size_t freeIdx;
+
+    // Hash index into free ring, holds ring index + 1, 0 marks empty slot
+    size_t* freeIndex;
+
+    // Only used in debug law, MTRACK_MAX_STRING_LEN chars per ring entry
+    char* freeInfo;
+
+    int orphaned;           // Owning thread exited, record can be adopted by a new thread
+    mrecord_t* next;
+};
+
 //
 //  Globals
 //
 size_t g_memAllocated = 0;
 
-mblock_t* g_memBuf = NULL;
-size_t g_memBufSize = 0;
-
 size_t g_mTrackWarning = 0;
 size_t g_mTrackLimit = 0;
 
-void** g_memFreeBuf = NULL;
-size_t g_freeBufSize = 0;
-size_t g_freeBufIdx = 0;
+// Per thread records, list only grows, records of exited threads are reused
+mrecord_t* g_memRecords = NULL;
+SDL_SpinLock g_memRecordLock = 0;
+SDL_TLSID g_memRecordTLS;
+
+SDL_SpinLock g_memInitLock = 0;
+SDL_SpinLock g_memLazyLock = 0;
 
-// Only used in debug law
-char** g_freeInfoBuf = NULL;
+size_t g_freeIndexSize = 0;
+
+// Records are only used in normal and debug law
+bool g_memTables = 0;
+
+// Scratch memory of the main thread, created on first use
+marena_t* g_memFrameArena = NULL;
 
 // Control modes
 control_law g_mTrackLaw = MTRACK_UNINITIALIZED;
@@ -35,12 +89,50 @@ bool g_mdebugMemtrack = 0;
 //                                                                            //
 // ========================================================================== //
 
+// Read law without lock, once initialized the tables it was published with are visible too
+control_law __loadLaw(void)
+{
+    control_law law = *(volatile control_law*) &g_mTrackLaw;
+
+    SDL_MemoryBarrierAcquire();
+
+    return law;
+}
+
+// Tables and first record must be complete before law leaves MTRACK_UNINITIALIZED
+void __publishLaw(control_law law)
+{
+    SDL_MemoryBarrierRelease();
+
+    *(volatile control_law*) &g_mTrackLaw = law;
+}
+
+// Initialize on first use, safe if several threads allocate first at once
+void __lazyInitialize(void)
+{
+    if (__loadLaw() != MTRACK_UNINITIALIZED)
+    {
+        return;
+    }
+
+    // Separate lock, memInit takes g_memInitLock itself
+    SDL_LockSpinlock(&g_memLazyLock);
+
+    if (__loadLaw() == MTRACK_UNINITIALIZED)
+    {
+        memInit();
+    }
+
+    SDL_UnlockSpinlock(&g_memLazyLock);
+}
+
 // Return 0 if memory can be allocated, 1 if not
+// Limits are checked against a snapshot, concurrent allocations can overshoot slightly
 int __sizeOverflow(size_t size)
 {
     rAssert(size);
 
-    if (!g_memBuf || g_mTrackLaw < 3)
+    if (!g_memTables || g_mTrackLaw < 3)
     {
         if (g_mTrackWarning || g_mTrackLimit)
         {
@@ -50,399 +142,673 @@ int __sizeOverflow(size_t size)
         return 0;
     }
 
-    if (g_mTrackLimit && g_mTrackLimit < g_memAllocated + size)
+    size_t allocated = __atomicLoad(&g_memAllocated);
+
+    if (g_mTrackLimit && g_mTrackLimit < allocated + size)
     {
         rDebugPrintf("[MEMTRACK]: Allocating %lld bytes would exceed set limit of %lld bytes", size, g_mTrackLimit);
         return 1;
     }
 
-    if (g_mTrackWarning && g_mTrackWarning < g_memAllocated + size)
+    if (g_mTrackWarning && g_mTrackWarning < allocated + size)
     {
-        rDebugPrintf("[MEMTRACK]: %lld bytes allocated", g_memAllocated + size);
+        rDebugPrintf("[MEMTRACK]: %lld bytes allocated", allocated + size);
     }
 
     return 0;
 }
 
-// Append ptr and size to allocated buffer and increase buffer if necessary
-void __setAllocated(void* ptr, size_t size)
+// Hash pointer to table slot, mask is table size - 1
+static inline size_t __hashPtr(const void* ptr, size_t mask)
 {
-    rAssert(ptr);
-    rAssert(size);
+    unsigned long long h = (unsigned long long) (size_t) ptr * 0x9e3779b97f4a7c15ull;
 
-    if (!ptr || g_mTrackLaw < 2)
+    return (size_t) (h >> 29) & mask;
+}
+
+mrecord_t* __createRecord(void)
+{
+    mrecord_t* rec = calloc(1, sizeof(mrecord_t));
+
+    if (!rec)
     {
-        return;
+        return NULL;
     }
 
-    if (!g_memBuf || g_mTrackLaw == MTRACK_DEGRADED_LAW)
+    // Hash tables need a power of 2 size
+    rec->bufSize = 16;
+
+    while (rec->bufSize < MTRACK_BUF_SIZE)
     {
-        g_memAllocated++;
-        return;
+        rec->bufSize *= 2;
     }
 
-    g_memAllocated += size;
+    rec->buf = calloc(rec->bufSize, sizeof(mblock_t));
+    rec->freeBuf = calloc(MTRACK_FREE_SET_SIZE, sizeof(void*));
+    rec->freeIndex = calloc(g_freeIndexSize, sizeof(size_t));
 
-    for (size_t i = 0; i < g_memBufSize; i++)
+    if (g_mTrackLaw == MTRACK_DEBUG_LAW)
     {
-        if (!g_memBuf[i].ptr && !g_memBuf[i].size)
-        {
-            g_memBuf[i].ptr = ptr;
-            g_memBuf[i].size = size;
+        rec->freeInfo = calloc(MTRACK_FREE_SET_SIZE, MTRACK_MAX_STRING_LEN);
+    }
 
-            if (g_mTrackLaw == MTRACK_DEBUG_LAW && g_mdebugMemtrack)
-            {
-                printf("[MEMTRACK]: Memory block of size %lld has been appended to buffer\n", size);
-            }
+    if (!rec->buf || !rec->freeBuf || !rec->freeIndex || (g_mTrackLaw == MTRACK_DEBUG_LAW && !rec->freeInfo))
+    {
+        free(rec->buf);
+        free(rec->freeBuf);
+        free(rec->freeIndex);
+        free(rec->freeInfo);
+        free(rec);
 
-            return;
-        }
+        return NULL;
     }
 
-    mblock_t* tmp = (mblock_t*) realloc(g_memBuf, (g_memBufSize + 32) * sizeof(mblock_t));
+    return rec;
+}
 
-    if (!tmp)
-    {
-        rDebugString("[MEMTRACK]: Buffer realloc failed, memtrack running in degraded law");
+// TLS destructor, blocks stay tracked and can still be freed by other threads
+void SDLCALL __orphanRecord(void* value)
+{
+    mrecord_t* rec = (mrecord_t*) value;
 
-        free(g_memBuf);
+    SDL_LockSpinlock(&rec->lock);
 
-        g_mTrackLaw = MTRACK_DEGRADED_LAW;
-        g_memBuf = NULL;
-        g_memBufSize = 0;
+    rec->orphaned = 1;
 
-        return;
+    SDL_UnlockSpinlock(&rec->lock);
+}
+
+// Return record of calling thread, adopt or create one on first use
+mrecord_t* __getRecord(void)
+{
+    mrecord_t* rec = (mrecord_t*) SDL_GetTLS(&g_memRecordTLS);
+
+    if (rec)
+    {
+        return rec;
     }
 
-    tmp[g_memBufSize].ptr = ptr;
-    tmp[g_memBufSize].size = size;
+    SDL_LockSpinlock(&g_memRecordLock);
+
+    for (mrecord_t* i = g_memRecords; i && !rec; i = i->next)
+    {
+        SDL_LockSpinlock(&i->lock);
+
+        if (i->orphaned)
+        {
+            i->orphaned = 0;
+            rec = i;
+        }
+
+        SDL_UnlockSpinlock(&i->lock);
+    }
 
-    for (unsigned i = 1; i < 32; i++)
+    if (!rec && (rec = __createRecord()))
     {
-        tmp[g_memBufSize + i].ptr = NULL;
-        tmp[g_memBufSize + i].size = 0;
+        rec->next = g_memRecords;
+        g_memRecords = rec;
     }
 
-    g_memBufSize += 32;
-    g_memBuf = tmp;
+    SDL_UnlockSpinlock(&g_memRecordLock);
 
-    if (g_mTrackLaw == MTRACK_DEBUG_LAW && g_mdebugMemtrack)
+    if (!rec)
     {
-        printf("[MEMTRACK]: Buffer size increased by 32 elements to %lld, block of size %lld appended\n", g_memBufSize, size);
+        rDebugString("[MEMTRACK]: Thread record allocation failed");
+        return NULL;
     }
+
+    SDL_SetTLS(&g_memRecordTLS, rec, __orphanRecord);
+
+    return rec;
 }
 
-// Remove entry from buffer if size 0
-// Find index of entry if size > 0
-int __resetAllocated(void* ptr, size_t size)
+// Return live block entry of ptr in record, NULL if not tracked there, record must be locked
+mblock_t* __findAllocated(mrecord_t* rec, void* ptr)
 {
-    if (!ptr || g_mTrackLaw < 2)
+    size_t mask = rec->bufSize - 1;
+
+    for (size_t i = __hashPtr(ptr, mask); rec->buf[i].ptr; i = (i + 1) & mask)
     {
-        return 0;
+        if (rec->buf[i].ptr == ptr)
+        {
+            return rec->buf + i;
+        }
     }
 
-    if (!g_memBuf || g_mTrackLaw == MTRACK_DEGRADED_LAW)
+    return NULL;
+}
+
+// Find record holding ptr and return it locked, calling thread's record is tried first
+mrecord_t* __lockOwner(void* ptr, mblock_t** block)
+{
+    mrecord_t* own = __getRecord();
+
+    if (own)
     {
-        if (size == 0)
+        SDL_LockSpinlock(&own->lock);
+
+        if ((*block = __findAllocated(own, ptr)))
         {
-            g_memAllocated--;
+            return own;
         }
 
-        return 1;
+        SDL_UnlockSpinlock(&own->lock);
     }
 
-    for (unsigned i = 0; i < g_memBufSize; i++)
-    {
-        if (g_memBuf[i].ptr == ptr)
-        {
-            if (size)
-            {
-                long n = size - g_memBuf[i].size;
+    // Block was allocated by another thread, records are never removed while running
+    mrecord_t* owner = NULL;
 
-                if (n > 0 && __sizeOverflow(n))
-                {
-                    return 0;
-                }
+    SDL_LockSpinlock(&g_memRecordLock);
 
-                return i;
-            }
+    for (mrecord_t* i = g_memRecords; i && !owner; i = i->next)
+    {
+        if (i == own)
+        {
+            continue;
+        }
 
-            g_memAllocated -= g_memBuf[i].size;
+        SDL_LockSpinlock(&i->lock);
 
-            g_memBuf[i].ptr = NULL;
-            g_memBuf[i].size = 0;
-            
-            return 1;
+        if ((*block = __findAllocated(i, ptr)))
+        {
+            owner = i;
+        }
+        else
+        {
+            SDL_UnlockSpinlock(&i->lock);
         }
     }
 
-    return 0;
+    SDL_UnlockSpinlock(&g_memRecordLock);
+
+    return owner;
 }
 
-// Append ptr to free buffer and increase buffer size if necessary
-// Same for freeInfo buffer if memtrack is in debug law
-void __appendFree(void* ptr, const char* filename, unsigned linenum)
+// Insert into live block table without checks, table must have a free slot
+void __insertAllocated(mblock_t* table, size_t tableSize, void* ptr, size_t size)
 {
-    if (!ptr || !g_memFreeBuf || g_mTrackLaw < 3)
+    size_t mask = tableSize - 1;
+    size_t i = __hashPtr(ptr, mask);
+
+    while (table[i].ptr)
     {
-        return;
+        i = (i + 1) & mask;
     }
 
-    if (g_freeBufIdx >= g_freeBufSize)
-    {
-        g_freeBufIdx = g_freeBufSize;
-        g_freeBufSize += 32;
+    table[i].ptr = ptr;
+    table[i].size = size;
+}
 
-        void** tmp = realloc(g_memFreeBuf, g_freeBufSize * sizeof(void*));
+// Double live block table size and rehash, return 0 on failure, record must be locked
+int __growAllocated(mrecord_t* rec)
+{
+    size_t size = rec->bufSize * 2;
 
-        if (!tmp)
-        {
-            goto fail;
-        }
+    mblock_t* tmp = (mblock_t*) calloc(size, sizeof(mblock_t));
 
-        g_memFreeBuf = tmp;
+    if (!tmp)
+    {
+        return 0;
+    }
 
-        if (g_mTrackLaw == MTRACK_DEBUG_LAW)
+    for (size_t i = 0; i < rec->bufSize; i++)
+    {
+        if (rec->buf[i].ptr)
         {
-            char** info = realloc(g_freeInfoBuf, g_freeBufSize * sizeof(char*));
-
-            if (!info)
-            {
-                goto fail;
-            }
-
-            g_freeInfoBuf = info;
+            __insertAllocated(tmp, size, rec->buf[i].ptr, rec->buf[i].size);
         }
     }
 
-    if (g_mTrackLaw == MTRACK_DEBUG_LAW)
-    {
-        char* str = malloc(MTRACK_MAX_STRING_LEN * sizeof(char));
+    free(rec->buf);
 
-        snprintf(str, MTRACK_MAX_STRING_LEN, "file: %s, line %d", filename, linenum);
+    rec->buf = tmp;
+    rec->bufSize = size;
 
-        g_freeInfoBuf[g_freeBufIdx] = str;
+    if (g_mTrackLaw == MTRACK_DEBUG_LAW && g_mdebugMemtrack)
+    {
+        printf("[MEMTRACK]: Buffer size increased to %lld elements\n", rec->bufSize);
     }
-    
-    g_memFreeBuf[g_freeBufIdx++] = ptr;
 
-    return;
-
-    fail:
-        
-    rDebugString("[MEMTRACK]: Buffer realloc failed, memtrack running in degraded law");
-
-    free(g_memFreeBuf);
-    free(g_freeInfoBuf);
-
-    g_memFreeBuf = NULL;
-    g_freeInfoBuf = NULL;
-    g_freeBufSize = 0;
-    g_mTrackLaw = MTRACK_DEGRADED_LAW;
+    return 1;
 }
 
-// Return index if ptr is in free buffer
-int __isFree(void* ptr)
+// Remove entry from live block table, record must be locked
+void __removeAllocated(mrecord_t* rec, mblock_t* block)
 {
-    if (!ptr || !g_memFreeBuf || g_mTrackLaw < 3)
-    {
-        return -1;
-    }
+    rec->bufCount--;
+
+    // Backward shift deletion, move later entries of the probe sequence into the hole
+    size_t mask = rec->bufSize - 1;
+    size_t hole = block - rec->buf;
 
-    for (size_t i = 0; i < g_freeBufSize; i++)
+    for (size_t i = (hole + 1) & mask; rec->buf[i].ptr; i = (i + 1) & mask)
     {
-        if (g_memFreeBuf[i] == ptr)
+        size_t home = __hashPtr(rec->buf[i].ptr, mask);
+
+        // Entry can move if its home slot is not cyclically within (hole, i]
+        if (((i - home) & mask) >= ((i - hole) & mask))
         {
-            return i;
+            rec->buf[hole] = rec->buf[i];
+            hole = i;
         }
     }
 
-    return -1;
+    rec->buf[hole].ptr = NULL;
+    rec->buf[hole].size = 0;
 }
 
-// ========================================================================== //
-//                                                                            //
-//  Memtrack implementation                                                   //
-//                                                                            //
-// ========================================================================== //
-
-// Optional explicit initialization
-void memtrackInitialize_Implementation(control_law law)
+// Add ptr and size to live blocks of calling thread and increase table if necessary
+void __setAllocated(void* ptr, size_t size)
 {
-    if (g_mTrackLaw != MTRACK_UNINITIALIZED)
+    rAssert(ptr);
+    rAssert(size);
+
+    if (!ptr || g_mTrackLaw < 2)
     {
-        rDebugString("[MEMTRACK]: Already initialized");
         return;
     }
 
-    if (law == MTRACK_UNINITIALIZED)
+    if (!g_memTables || g_mTrackLaw == MTRACK_DEGRADED_LAW)
     {
-        rDebugString("[MEMTRACK]: Initialization failed, invalid control law");
+        __atomicAdd(&g_memAllocated, 1);
         return;
     }
 
-    #ifndef MTRACK_BUF_SIZE
-        #define MTRACK_BUF_SIZE 256
-        rDebugString("[MEMTRACK]: MTRACK_BUF_SIZE not defined, defaulting to 256");
-    #endif
+    mrecord_t* rec = __getRecord();
 
-    if (MTRACK_BUF_SIZE <= 0)
+    if (!rec)
     {
-        rDebugString("[MEMTRACK]: Memtrack initialization failed, invalid MTRACK_BUF_SIZE definition");
+        rDebugString("[MEMTRACK]: No thread record, memory block not tracked");
         return;
     }
 
-    #ifndef MTRACK_MANUAL_CLEANUP
-        atexit(memtrackCleanup_Implementation);
-    #endif
+    SDL_LockSpinlock(&rec->lock);
 
-    if (law > 4)
+    // Keep load factor below 3/4 so probe sequences stay short
+    if ((rec->bufCount + 1) * 4 > rec->bufSize * 3 && !__growAllocated(rec))
     {
-        rDebugString("[MEMTRACK]: Invalid memtrack mode on initialization, memtrack running in normal law");
+        SDL_UnlockSpinlock(&rec->lock);
 
-        law = MTRACK_NORMAL_LAW;
-    }
-
-    g_mTrackLaw = law;
+        rDebugString("[MEMTRACK]: Buffer realloc failed, memory block not tracked");
 
-    if (law < 3)
-    {
-        rAssert(law);
         return;
     }
 
-    g_memBuf = malloc(MTRACK_BUF_SIZE * sizeof(mblock_t));
-    g_memFreeBuf = malloc(MTRACK_BUF_SIZE * sizeof(void*));
-
-    g_memBufSize = MTRACK_BUF_SIZE;
-    g_freeBufSize = MTRACK_BUF_SIZE;
-    g_memAllocated = 0;
-
-    if (g_mTrackLaw == MTRACK_DEBUG_LAW)
-    {
-        g_freeInfoBuf = malloc(MTRACK_BUF_SIZE * sizeof(char*));
-    }
-
-    if (g_memBuf && g_memFreeBuf && (g_mTrackLaw != MTRACK_DEBUG_LAW || g_freeInfoBuf))
-    {
-        for (unsigned i = 0; i < g_memBufSize; i++)
-        {
-            g_memBuf[i].ptr = NULL;
-            g_memBuf[i].size = 0;
-
-            g_memFreeBuf[i] = NULL;
+    __insertAllocated(rec->buf, rec->bufSize, ptr, size);
 
-            if (g_freeInfoBuf)
-            {
-                g_freeInfoBuf[i] = NULL;
-            }
-        }
+    rec->bufCount++;
 
-        g_memBuf[0].ptr = g_memBuf;
-        g_memBuf[0].size = g_memBufSize * sizeof(mblock_t);
-    }
-    else
-    {
-        rDebugString("Memtrack buffer initialization error, memtrack running in degraded law");
+    SDL_UnlockSpinlock(&rec->lock);
 
-        g_mTrackLaw = MTRACK_DEGRADED_LAW;
-        g_memBuf = NULL;
-        g_memFreeBuf = NULL;
-        g_freeInfoBuf = NULL;
-        g_memBufSize = 0;
-        g_freeBufSize = 0;
-    }
+    __atomicAdd(&g_memAllocated, size);
 
-    if (g_mTrackLaw == MTRACK_DEBUG_LAW && g_mdebugMemtrack && g_memBuf && g_memFreeBuf)
+    if (g_mTrackLaw == MTRACK_DEBUG_LAW && g_mdebugMemtrack)
     {
-        printf("[MEMTRACK]: Initialization successful, memtrack buffers have been allocated: %lld bytes\n", g_memBufSize);
+        printf("[MEMTRACK]: Memory block of size %lld has been appended to buffer\n", size);
     }
 }
 
-void memtrackChangeLaw_Implementation(control_law law)
+// Remove ptr from live blocks of whichever thread allocated it, return 1 if it was tracked
+int __resetAllocated(void* ptr)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
+    if (!ptr || g_mTrackLaw < 2)
     {
-        memtrackInitialize_Implementation(law);
-        return;
+        return 0;
     }
 
-    if (law < 1 || law > 4)
+    if (!g_memTables || g_mTrackLaw == MTRACK_DEGRADED_LAW)
     {
-        rDebugString("[MEMTRACK]: Invalid memtrack control law");
-        return;
+        __atomicSub(&g_memAllocated, 1);
+        return 1;
     }
 
-    if (law > 2 && (g_memBuf == NULL || g_memFreeBuf == NULL))
-    {
-        rDebugString("[MEMTRACK]: Buffers not initialized, control law could not be changed");
-        return;
-    }
+    mblock_t* block;
+    mrecord_t* owner = __lockOwner(ptr, &block);
 
-    if ((g_mTrackLaw < 3 && law > 2) || (g_mTrackLaw > 2 && law < 3))
+    if (!owner)
     {
-        rDebugString("[MEMTRACK]: Switching between normal/debug and degraded/direct law is not recommended");
+        return 0;
     }
 
-    g_mTrackLaw = law;
+    size_t size = block->size;
+
+    __removeAllocated(owner, block);
+
+    SDL_UnlockSpinlock(&owner->lock);
+
+    __atomicSub(&g_memAllocated, size);
+
+    return 1;
 }
 
-void memtrackSetup_Implementation(control_law law, bool dAlloc, bool dRealloc, bool dFree, bool dMtrack)
+// Return index of ptr in free ring of record, -1 if not found, record must be locked
+int __isFree(mrecord_t* rec, void* ptr)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
+    size_t mask = g_freeIndexSize - 1;
+
+    for (size_t i = __hashPtr(ptr, mask); rec->freeIndex[i]; i = (i + 1) & mask)
     {
-        memtrackInitialize_Implementation(law);
+        if (rec->freeBuf[rec->freeIndex[i] - 1] == ptr)
+        {
+            return (int) (rec->freeIndex[i] - 1);
+        }
     }
-    else if (law && law <= 4)
+
+    return -1;
+}
+
+// Remove ring entry from free index, backward shift deletion as for live blocks
+void __eraseFree(mrecord_t* rec, size_t ring)
+{
+    size_t mask = g_freeIndexSize - 1;
+    size_t hole = __hashPtr(rec->freeBuf[ring], mask);
+
+    while (rec->freeIndex[hole] != ring + 1)
     {
-        rWarningMsg(law == MTRACK_DEBUG_LAW, "Memtrack setup only takes effect if law is debug");
+        rAssert(rec->freeIndex[hole]);
 
-        g_mTrackLaw = law;
+        hole = (hole + 1) & mask;
     }
-    else
+
+    for (size_t i = (hole + 1) & mask; rec->freeIndex[i]; i = (i + 1) & mask)
     {
-        rDebugString("[MEMTRACK]: Setup failed, invalid control law");
-        return;
+        size_t home = __hashPtr(rec->freeBuf[rec->freeIndex[i] - 1], mask);
+
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            rec->freeIndex[hole] = rec->freeIndex[i];
+            hole = i;
+        }
     }
-    
-    g_mdebugAllocs = dAlloc;
-    g_mdebugReallocs = dRealloc;
-    g_mdebugFrees = dFree;
-    g_mdebugMemtrack = dMtrack;
+
+    rec->freeIndex[hole] = 0;
 }
 
-void* memtrackAllocate_Implementation(size_t size)
+// Remember ptr as freed by calling thread, oldest entry is forgotten once ring is full
+// Also store where it was freed if memtrack is in debug law
+void __appendFree(void* ptr, const char* filename, unsigned linenum)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
+    if (!ptr || !g_memTables || g_mTrackLaw < 3)
     {
-        memInit();
+        return;
     }
 
-    if (size <= 0 || __sizeOverflow(size))
+    mrecord_t* rec = __getRecord();
+
+    if (!rec)
     {
-        rDebugPrintf("[MEMTRACK]: Memory not allocated, size: %lld\n", size);
-        return NULL;
+        return;
     }
 
-    void* ptr = malloc(size);
+    SDL_LockSpinlock(&rec->lock);
 
-    rAssert(ptr);
+    int found = __isFree(rec, ptr);
+    size_t ring;
 
-    if (ptr)
+    if (found >= 0)
     {
-        __setAllocated(ptr, size);
+        // Address was reused by malloc and freed again, only update info
+        ring = found;
     }
+    else
+    {
+        ring = rec->freeIdx;
 
-    return ptr;
+        if (rec->freeBuf[ring])
+        {
+            __eraseFree(rec, ring);
+        }
+
+        rec->freeBuf[ring] = ptr;
+
+        size_t mask = g_freeIndexSize - 1;
+        size_t i = __hashPtr(ptr, mask);
+
+        while (rec->freeIndex[i])
+        {
+            i = (i + 1) & mask;
+        }
+
+        rec->freeIndex[i] = ring + 1;
+        rec->freeIdx = (ring + 1) % MTRACK_FREE_SET_SIZE;
+    }
+
+    if (g_mTrackLaw == MTRACK_DEBUG_LAW)
+    {
+        // Law may have been changed to debug after record was created
+        if (!rec->freeInfo)
+        {
+            rec->freeInfo = calloc(MTRACK_FREE_SET_SIZE, MTRACK_MAX_STRING_LEN);
+        }
+
+        if (rec->freeInfo)
+        {
+            snprintf(rec->freeInfo + ring * MTRACK_MAX_STRING_LEN, MTRACK_MAX_STRING_LEN, "file: %s, line %d", rNullStringWrap(filename), linenum);
+        }
+    }
+
+    SDL_UnlockSpinlock(&rec->lock);
 }
 
-void* memtrackAllocateInitialize_Implementation(size_t size, size_t count)
+// Search free rings of all threads, copy where ptr was freed to info if known
+int __findFreed(void* ptr, char* info)
+{
+    if (!ptr || !g_memTables || g_mTrackLaw < 3)
+    {
+        return 0;
+    }
+
+    int found = 0;
+
+    SDL_LockSpinlock(&g_memRecordLock);
+
+    for (mrecord_t* rec = g_memRecords; rec && !found; rec = rec->next)
+    {
+        SDL_LockSpinlock(&rec->lock);
+
+        int i = __isFree(rec, ptr);
+
+        if (i >= 0)
+        {
+            found = 1;
+
+            if (rec->freeInfo && rec->freeInfo[i * MTRACK_MAX_STRING_LEN])
+            {
+                memcpy(info, rec->freeInfo + i * MTRACK_MAX_STRING_LEN, MTRACK_MAX_STRING_LEN);
+            }
+            else
+            {
+                snprintf(info, MTRACK_MAX_STRING_LEN, "<unknown>");
+            }
+        }
+
+        SDL_UnlockSpinlock(&rec->lock);
+    }
+
+    SDL_UnlockSpinlock(&g_memRecordLock);
+
+    return found;
+}
+
+// ========================================================================== //
+//                                                                            //
+//  Memtrack implementation                                                   //
+//                                                                            //
+// ========================================================================== //
+
+// Optional explicit initialization, must happen before other threads allocate if law is to be chosen
+void memtrackInitialize_Implementation(control_law law)
+{
+    SDL_LockSpinlock(&g_memInitLock);
+
+    if (g_mTrackLaw != MTRACK_UNINITIALIZED)
+    {
+        SDL_UnlockSpinlock(&g_memInitLock);
+
+        rDebugString("[MEMTRACK]: Already initialized");
+        return;
+    }
+
+    if (law == MTRACK_UNINITIALIZED)
+    {
+        SDL_UnlockSpinlock(&g_memInitLock);
+
+        rDebugString("[MEMTRACK]: Initialization failed, invalid control law");
+        return;
+    }
+
+    #ifndef MTRACK_BUF_SIZE
+        #define MTRACK_BUF_SIZE 256
+        rDebugString("[MEMTRACK]: MTRACK_BUF_SIZE not defined, defaulting to 256");
+    #endif
+
+    if (MTRACK_BUF_SIZE <= 0)
+    {
+        SDL_UnlockSpinlock(&g_memInitLock);
+
+        rDebugString("[MEMTRACK]: Memtrack initialization failed, invalid MTRACK_BUF_SIZE definition");
+        return;
+    }
+
+    #ifndef MTRACK_MANUAL_CLEANUP
+        // Memtrack can be initialized again after cleanup, register only once
+        static bool registered = 0;
+
+        if (!registered)
+        {
+            atexit(memtrackCleanup_Implementation);
+            registered = 1;
+        }
+    #endif
+
+    if (law > 4)
+    {
+        rDebugString("[MEMTRACK]: Invalid memtrack mode on initialization, memtrack running in normal law");
+
+        law = MTRACK_NORMAL_LAW;
+    }
+
+    g_memAllocated = 0;
+
+    if (law < 3)
+    {
+        rAssert(law);
+
+        __publishLaw(law);
+
+        SDL_UnlockSpinlock(&g_memInitLock);
+
+        return;
+    }
+
+    g_freeIndexSize = 16;
+
+    while (g_freeIndexSize < MTRACK_FREE_SET_SIZE * 2)
+    {
+        g_freeIndexSize *= 2;
+    }
+
+    // Law is published last so threads that skip the locks in __lazyInitialize see complete state
+    // First record is created before that, in debug law it allocates its free info on first free
+    g_memTables = 1;
+
+    if (!__getRecord())
+    {
+        rDebugString("Memtrack buffer initialization error, memtrack running in degraded law");
+
+        g_memTables = 0;
+        g_freeIndexSize = 0;
+        law = MTRACK_DEGRADED_LAW;
+    }
+
+    __publishLaw(law);
+
+    SDL_UnlockSpinlock(&g_memInitLock);
+
+    if (g_mTrackLaw == MTRACK_DEBUG_LAW && g_mdebugMemtrack && g_memTables)
+    {
+        printf("[MEMTRACK]: Initialization successful, memtrack buffers have been allocated: %lld elements\n", g_memRecords->bufSize);
+    }
+}
+
+void memtrackChangeLaw_Implementation(control_law law)
 {
     if (g_mTrackLaw == MTRACK_UNINITIALIZED)
     {
-        memInit();
+        memtrackInitialize_Implementation(law);
+        return;
+    }
+
+    if (law < 1 || law > 4)
+    {
+        rDebugString("[MEMTRACK]: Invalid memtrack control law");
+        return;
+    }
+
+    if (law > 2 && !g_memTables)
+    {
+        rDebugString("[MEMTRACK]: Buffers not initialized, control law could not be changed");
+        return;
+    }
+
+    if ((g_mTrackLaw < 3 && law > 2) || (g_mTrackLaw > 2 && law < 3))
+    {
+        rDebugString("[MEMTRACK]: Switching between normal/debug and degraded/direct law is not recommended");
+    }
+
+    g_mTrackLaw = law;
+}
+
+void memtrackSetup_Implementation(control_law law, bool dAlloc, bool dRealloc, bool dFree, bool dMtrack)
+{
+    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
+    {
+        memtrackInitialize_Implementation(law);
+    }
+    else if (law && law <= 4)
+    {
+        rWarningMsg(law == MTRACK_DEBUG_LAW, "Memtrack setup only takes effect if law is debug");
+
+        g_mTrackLaw = law;
+    }
+    else
+    {
+        rDebugString("[MEMTRACK]: Setup failed, invalid control law");
+        return;
+    }
+    
+    g_mdebugAllocs = dAlloc;
+    g_mdebugReallocs = dRealloc;
+    g_mdebugFrees = dFree;
+    g_mdebugMemtrack = dMtrack;
+}
+
+void* memtrackAllocate_Implementation(size_t size)
+{
+    __lazyInitialize();
+
+    if (size <= 0 || __sizeOverflow(size))
+    {
+        rDebugPrintf("[MEMTRACK]: Memory not allocated, size: %lld\n", size);
+        return NULL;
+    }
+
+    void* ptr = malloc(size);
+
+    rAssert(ptr);
+
+    if (ptr)
+    {
+        __setAllocated(ptr, size);
     }
 
+    return ptr;
+}
+
+void* memtrackAllocateInitialize_Implementation(size_t size, size_t count)
+{
+    __lazyInitialize();
+
     if (size <= 0 || count <= 0 || __sizeOverflow(size * count))
     {
         rDebugPrintf("[MEMTRACK]: Memory not allocated, size: %lld\n", size * count);
@@ -481,14 +847,9 @@ void* memtrackReallocate_Implementation(void* ptr, size_t size)
     rAssert(ptr);
     rAssert(size);
 
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
-    {
-        memInit();
-    }
-
-    int i = __resetAllocated(ptr, size);
+    __lazyInitialize();
 
-    if (i == 0)
+    if (!ptr || g_mTrackLaw < 2)
     {
         goto fail;
     }
@@ -502,8 +863,39 @@ void* memtrackReallocate_Implementation(void* ptr, size_t size)
         return NULL;
     }
 
-    if (g_mTrackLaw > 2 && g_memBuf && g_memBuf[i].size == size)
+    if (g_mTrackLaw < 3 || !g_memTables)
+    {
+        void* tmp = realloc(ptr, size);
+
+        if (tmp)
+        {
+            return tmp;
+        }
+
+        goto fail;
+    }
+
+    // Owner stays locked across realloc so no other thread can free the block meanwhile
+    mblock_t* block;
+    mrecord_t* owner = __lockOwner(ptr, &block);
+
+    if (!owner)
     {
+        goto fail;
+    }
+
+    size_t oldSize = block->size;
+
+    if (size > oldSize && __sizeOverflow(size - oldSize))
+    {
+        SDL_UnlockSpinlock(&owner->lock);
+        goto fail;
+    }
+
+    if (oldSize == size)
+    {
+        SDL_UnlockSpinlock(&owner->lock);
+
         rDebugString("[MEMTRACK]: No realloc necessary");
 
         return ptr;
@@ -511,19 +903,34 @@ void* memtrackReallocate_Implementation(void* ptr, size_t size)
 
     void* tmp = realloc(ptr, size);
 
-    if (tmp)
+    if (!tmp)
     {
-        if (g_mTrackLaw > 2 && g_memBuf)
-        {
-            g_memAllocated += size - g_memBuf[i].size;
+        SDL_UnlockSpinlock(&owner->lock);
+        goto fail;
+    }
 
-            g_memBuf[i].size = size;
-            g_memBuf[i].ptr = tmp;
-        }
+    if (tmp == ptr)
+    {
+        block->size = size;
+
+        SDL_UnlockSpinlock(&owner->lock);
+
+        __atomicAdd(&g_memAllocated, size - oldSize);
+    }
+    else
+    {
+        // Block moved, table is keyed by address, new block belongs to calling thread
+        __removeAllocated(owner, block);
+
+        SDL_UnlockSpinlock(&owner->lock);
 
-        return tmp;
+        __atomicSub(&g_memAllocated, oldSize);
+
+        __setAllocated(tmp, size);
     }
 
+    return tmp;
+
     fail:
     
     rDebugString("[MEMTRACK]: Realloc failed");
@@ -533,19 +940,17 @@ void* memtrackReallocate_Implementation(void* ptr, size_t size)
 
 int memtrackFree_Implementation(void* ptr, const char* filename, unsigned linenum)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
-    {
-        memInit();
-    }
+    __lazyInitialize();
 
     if (!ptr)
     {
         return 1;
     }
 
-    if (__resetAllocated(ptr, 0))
+    if (__resetAllocated(ptr))
     {
-        __appendFree(ptr, NULL, 0);
+        // Record before free, once freed the address can be handed out to another thread
+        __appendFree(ptr, filename, linenum);
 
         free(ptr);
 
@@ -553,24 +958,26 @@ int memtrackFree_Implementation(void* ptr, const char* filename, unsigned linenu
     }
     else
     {
-        int i = __isFree(ptr);
+        char info[MTRACK_MAX_STRING_LEN];
 
-        if (i >= 0 && g_mTrackLaw == MTRACK_DEBUG_LAW && g_freeInfoBuf)
+        if (__findFreed(ptr, info))
         {
-            printf
-            (
-                "[FATAL]: Pointer freed in file %s, line %d has already been freed\n"
-                "         Pointer was first freed in %s\n",
-                rNullStringWrap(filename), linenum, rNullStringWrap(g_freeInfoBuf[i])
-            );
+            if (g_mTrackLaw == MTRACK_DEBUG_LAW)
+            {
+                printf
+                (
+                    "[FATAL]: Pointer freed in file %s, line %d has already been freed\n"
+                    "         Pointer was first freed in %s\n",
+                    rNullStringWrap(filename), linenum, info
+                );
+            }
+            else
+            {
+                rDebugPrintf("[MEMTRACK]: Pointer %p has already been freed", ptr);
+            }
 
             return 0;
         }
-        else if (i >= 0)
-        {
-            rDebugPrintf("[MEMTRACK]: Pointer %p has already been freed", ptr);
-            return 0;
-        }
     }
     
     rDebugString("[MEMTRACK]: Memory block not found in memtrack buffer, block not freed");
@@ -581,12 +988,9 @@ int memtrackFree_Implementation(void* ptr, const char* filename, unsigned linenu
 // Display warning if set amount of memory is exceeded
 void memtrackSetWarning_Implementation(size_t size)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
-    {
-        memInit();
-    }
+    __lazyInitialize();
 
-    rAssert(g_memBuf);
+    rAssert(g_memTables);
 
     rWarningMsg(g_mTrackLaw < 3, "Memtrack warning only takes effect in normal or debug law");
 
@@ -601,22 +1005,66 @@ void memtrackSetWarning_Implementation(size_t size)
 // Prevent memory allocation beyond set limit
 void memtrackSetLimit_Implementation(size_t size)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED)
-    {
-        memInit();
-    }
+    __lazyInitialize();
 
-    rAssert(g_memBuf);
+    rAssert(g_memTables);
 
     rWarningMsg(g_mTrackLaw < 3, "Memtrack limit only takes effect in normal or debug law");
 
     g_mTrackLimit = size;
 }
 
+// Merge records of all threads and print totals, can be called while other threads allocate
+void memtrackReport_Implementation(void)
+{
+    if (!g_memTables)
+    {
+        printf("[MEMTRACK]: %lld bytes allocated, no block records\n", __atomicLoad(&g_memAllocated));
+        return;
+    }
+
+    size_t threads = 0;
+    size_t orphaned = 0;
+    size_t blocks = 0;
+    size_t bytes = 0;
+
+    SDL_LockSpinlock(&g_memRecordLock);
+
+    for (mrecord_t* rec = g_memRecords; rec; rec = rec->next)
+    {
+        SDL_LockSpinlock(&rec->lock);
+
+        threads++;
+        orphaned += rec->orphaned;
+        blocks += rec->bufCount;
+
+        for (size_t i = 0; i < rec->bufSize; i++)
+        {
+            bytes += rec->buf[i].size;
+        }
+
+        SDL_UnlockSpinlock(&rec->lock);
+    }
+
+    SDL_UnlockSpinlock(&g_memRecordLock);
+
+    printf
+    (
+        "[MEMTRACK]: %lld thread records (%lld exited), %lld live blocks, %lld bytes recorded, %lld bytes counted\n",
+        threads, orphaned, blocks, bytes, __atomicLoad(&g_memAllocated)
+    );
+
+    if (g_memFrameArena)
+    {
+        printf("[MEMTRACK]: Frame arena %lld bytes, peak %lld bytes per frame\n", g_memFrameArena->size, g_memFrameArena->peak);
+    }
+}
+
 // Unless MTRACK_MANUAL_CLEANUP is defined, calling cleanup is optional
+// Other threads must not use memtrack anymore once cleanup starts
 void memtrackCleanup_Implementation(void)
 {
-    if (g_mTrackLaw == MTRACK_UNINITIALIZED || !g_memBuf)
+    if (g_mTrackLaw == MTRACK_UNINITIALIZED || !g_memTables)
     {
         rWarning(g_memAllocated);
         return;
@@ -624,49 +1072,324 @@ void memtrackCleanup_Implementation(void)
 
     size_t allocated = 0;
 
-    if (g_memAllocated)
+    SDL_LockSpinlock(&g_memRecordLock);
+
+    for (mrecord_t* rec = g_memRecords; rec;)
     {
-        for (size_t i = 1; i < g_memBufSize; i++)
+        for (size_t i = 0; i < rec->bufSize && g_memAllocated; i++)
         {
-            if (g_memBuf[i].ptr && g_memBuf[i].size)
+            if (rec->buf[i].ptr && rec->buf[i].size)
             {
-                allocated += g_memBuf[i].size;
+                allocated += rec->buf[i].size;
 
-                free(g_memBuf[i].ptr);
+                free(rec->buf[i].ptr);
 
-                rDebugPrintf("[MEMTRACK]: Memory block with %lld bytes was freed automatically", g_memBuf[i].size);
+                rDebugPrintf("[MEMTRACK]: Memory block with %lld bytes was freed automatically", rec->buf[i].size);
             }
         }
 
-        rWarningMsg(g_memAllocated == allocated, "Allocated mem sizes disagree");
+        mrecord_t* next = rec->next;
 
-        if (allocated)
-        {
-            rDebugPrintf("[MEMTRACK]: Total bytes freed: %lld", allocated);
-        }
+        free(rec->buf);
+        free(rec->freeBuf);
+        free(rec->freeIndex);
+        free(rec->freeInfo);
+        free(rec);
+
+        rec = next;
     }
 
-    if (g_freeInfoBuf)
+    g_memRecords = NULL;
+
+    SDL_UnlockSpinlock(&g_memRecordLock);
+
+    rWarningMsg(g_memAllocated == allocated, "Allocated mem sizes disagree");
+
+    if (allocated)
     {
-        for (size_t i = 0; i < g_freeBufSize; i++)
-        {
-            free(g_freeInfoBuf[i]);
-        }
+        rDebugPrintf("[MEMTRACK]: Total bytes freed: %lld", allocated);
     }
 
-    free(g_memBuf);
-    free(g_memFreeBuf);
-    free(g_freeInfoBuf);
+    // Only the calling thread's slot can be cleared, records of other live threads are gone with the list
+    SDL_SetTLS(&g_memRecordTLS, NULL, NULL);
 
-    g_memBuf = NULL;
-    g_memFreeBuf = NULL;
-    g_freeInfoBuf = NULL;
+    g_memTables = 0;
     g_memAllocated = 0;
-    g_memBufSize = 0;
-    g_freeBufSize = 0;
+    g_freeIndexSize = 0;
+    g_memFrameArena = NULL;
     g_mTrackLaw = MTRACK_UNINITIALIZED;
 }
 
+// ========================================================================== //
+//                                                                            //
+//  Memtrack arena implementation                                             //
+//                                                                            //
+// ========================================================================== //
+
+// Blocks start with a pointer to the previous block, data follows aligned
+#define MTRACK_ARENA_HEADER (((sizeof(void*) + MTRACK_ARENA_ALIGN - 1) / MTRACK_ARENA_ALIGN) * MTRACK_ARENA_ALIGN)
+
+// Start new block, previous block stays valid until reset
+int __growArena(marena_t* arena, size_t size)
+{
+    size_t blockSize = arena->size * 2;
+
+    if (blockSize < size)
+    {
+        blockSize = size;
+    }
+
+    void* block = memAlloc(MTRACK_ARENA_HEADER + blockSize);
+
+    if (!block)
+    {
+        rDebugString("[MEMTRACK]: Arena block allocation failed");
+        return 0;
+    }
+
+    *(void**) block = arena->block;
+
+    arena->block = block;
+    arena->size = blockSize;
+    arena->used = 0;
+
+    return 1;
+}
+
+marena_t* memtrackArenaCreate_Implementation(size_t size)
+{
+    rAssert(size);
+
+    marena_t* arena = (marena_t*) memAlloc(sizeof(marena_t));
+
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    memset(arena, 0, sizeof(marena_t));
+
+    size = (size + MTRACK_ARENA_ALIGN - 1) & ~((size_t) MTRACK_ARENA_ALIGN - 1);
+
+    if (!__growArena(arena, size))
+    {
+        memFree(arena);
+        return NULL;
+    }
+
+    return arena;
+}
+
+// Return memory aligned to MTRACK_ARENA_ALIGN, NULL if no block could be added
+void* memtrackArenaAlloc_Implementation(marena_t* arena, size_t size)
+{
+    rAssert(arena);
+    rAssert(size);
+
+    size = (size + MTRACK_ARENA_ALIGN - 1) & ~((size_t) MTRACK_ARENA_ALIGN - 1);
+
+    if (arena->used + size > arena->size && !__growArena(arena, size))
+    {
+        return NULL;
+    }
+
+    void* ptr = (char*) arena->block + MTRACK_ARENA_HEADER + arena->used;
+
+    arena->used += size;
+    arena->total += size;
+
+    return ptr;
+}
+
+// Invalidate all memory of arena, keeps only the newest and largest block
+void memtrackArenaReset_Implementation(marena_t* arena)
+{
+    rAssert(arena);
+
+    void* prev = *(void**) arena->block;
+
+    while (prev)
+    {
+        void* tmp = *(void**) prev;
+
+        memFree(prev);
+
+        prev = tmp;
+    }
+
+    *(void**) arena->block = NULL;
+
+    if (arena->total > arena->peak)
+    {
+        arena->peak = arena->total;
+    }
+
+    arena->used = 0;
+    arena->total = 0;
+}
+
+void memtrackArenaDestroy_Implementation(marena_t* arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    memtrackArenaReset_Implementation(arena);
+
+    memFree(arena->block);
+    memFree(arena);
+}
+
+// Only to be used from the main thread
+void* memtrackFrameAlloc_Implementation(size_t size)
+{
+    if (!g_memFrameArena && !(g_memFrameArena = memtrackArenaCreate_Implementation(MTRACK_FRAME_ARENA_SIZE)))
+    {
+        return NULL;
+    }
+
+    return memtrackArenaAlloc_Implementation(g_memFrameArena, size);
+}
+
+void memtrackFrameReset_Implementation(void)
+{
+    if (g_memFrameArena)
+    {
+        memtrackArenaReset_Implementation(g_memFrameArena);
+    }
+}
+
+void memtrackFrameDestroy_Implementation(void)
+{
+    memtrackArenaDestroy_Implementation(g_memFrameArena);
+
+    g_memFrameArena = NULL;
+}
+
+// ========================================================================== //
+//                                                                            //
+//  Memtrack pool implementation                                              //
+//                                                                            //
+// ========================================================================== //
+
+// Element size rounded so elements never straddle a cache line
+size_t __poolStride(size_t elemSize)
+{
+    size_t stride = sizeof(void*);
+
+    if (elemSize > MTRACK_CACHE_LINE)
+    {
+        return (elemSize + MTRACK_CACHE_LINE - 1) & ~((size_t) MTRACK_CACHE_LINE - 1);
+    }
+
+    while (stride < elemSize)
+    {
+        stride *= 2;
+    }
+
+    return stride;
+}
+
+mpool_t* memtrackPoolCreate_Implementation(size_t elemSize, size_t count)
+{
+    rAssert(elemSize);
+    rAssert(count);
+
+    mpool_t* pool = (mpool_t*) memAlloc(sizeof(mpool_t));
+
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(mpool_t));
+
+    pool->stride = __poolStride(elemSize);
+    pool->count = count;
+    pool->mem = memAlloc(pool->stride * count + MTRACK_CACHE_LINE - 1);
+
+    if (!pool->mem)
+    {
+        rDebugString("[MEMTRACK]: Pool allocation failed");
+
+        memFree(pool);
+        return NULL;
+    }
+
+    pool->base = (char*) (((size_t) pool->mem + MTRACK_CACHE_LINE - 1) & ~((size_t) MTRACK_CACHE_LINE - 1));
+
+    memtrackPoolReset_Implementation(pool);
+
+    return pool;
+}
+
+// Return free element, NULL if pool is exhausted
+void* memtrackPoolAlloc_Implementation(mpool_t* pool)
+{
+    rAssert(pool);
+
+    void* ptr = pool->freeList;
+
+    if (!ptr)
+    {
+        return NULL;
+    }
+
+    pool->freeList = *(void**) ptr;
+
+    if (++pool->used > pool->peak)
+    {
+        pool->peak = pool->used;
+    }
+
+    return ptr;
+}
+
+void memtrackPoolFree_Implementation(mpool_t* pool, void* ptr)
+{
+    rAssert(pool);
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    rAssertMsg((char*) ptr >= pool->base && (char*) ptr < pool->base + pool->stride * pool->count, "Pointer not from this pool");
+    rAssertMsg(!(((char*) ptr - pool->base) % pool->stride), "Pointer not at element start");
+    rAssert(pool->used);
+
+    *(void**) ptr = pool->freeList;
+
+    pool->freeList = ptr;
+    pool->used--;
+}
+
+// Return all elements to pool, free list is rebuilt in address order
+void memtrackPoolReset_Implementation(mpool_t* pool)
+{
+    rAssert(pool);
+
+    for (size_t i = 0; i < pool->count; i++)
+    {
+        *(void**) (pool->base + i * pool->stride) = i + 1 < pool->count ? pool->base + (i + 1) * pool->stride : NULL;
+    }
+
+    pool->freeList = pool->base;
+    pool->used = 0;
+}
+
+void memtrackPoolDestroy_Implementation(mpool_t* pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    memFree(pool->mem);
+    memFree(pool);
+}
+
 // ========================================================================== //
 //                                                                            //
 //  Memtrack debug law implementation                                         //
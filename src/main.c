@@ -6,7 +6,10 @@
 #include <main.h>
 #include <render.h>
 #include <ascii.h>
-#include <worldsim.h>
+#include <worldrender.h>
+#include <pacer.h>
+#include <replay.h>
+#include <profiler.h>
 #include <debug/rdebug.h>
 #include <debug/memtrack.h>
 
@@ -14,30 +17,43 @@ static SDL_Window* window = NULL;
 
 SDL_Renderer* g_renderer = NULL;
 
-u64 ticksPerSecond;
 u64 currt;
 u64 prevt = 0;
 
 u8 state = 2;
 
+// simulation steps on its own thread, on this one if the thread could not be started
+bool simThread = 0;
+
+// game frames follow the display, physics ticks at the tick rate regardless
+u64 frameNS = SDL_MS_TO_NS(RENDER_FRAMETIME);
+
 const texinfo_t textures[3] = {
     {"..\\resources\\bird.bmp", TEXTURE_BIRD, INTERPOLATION_NONE},
     {"..\\resources\\pipe.bmp", TEXTURE_PIPE, INTERPOLATION_NONE},
     {"..\\resources\\cloud.bmp", TEXTURE_CLOUD, INTERPOLATION_NONE}
 };
 
+// frame interval from refresh rate of the display the window is on
+void updateFrameInterval(void)
+{
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+
+    if (mode && mode->refresh_rate > 0.0f)
+        frameNS = (u64) (SDL_NS_PER_SECOND / mode->refresh_rate);
+    else
+        frameNS = SDL_MS_TO_NS(RENDER_FRAMETIME);
+
+    SDL_Log("Frame interval %.3f ms", frameNS / 1e6);
+}
+
 //
 //  Start screen
 //
 void startScreen(void)
 {
-    // wait on spin
-    while (prevt && ((SDL_GetPerformanceCounter() * 1000) / ticksPerSecond) - prevt < MENU_FRAMETIME);
-
-    if (!prevt)
-        prevt = (SDL_GetPerformanceCounter() * 1000) / ticksPerSecond;
-
-    currt = (SDL_GetPerformanceCounter() * 1000) / ticksPerSecond;
+    pacerSetInterval(SDL_MS_TO_NS(MENU_FRAMETIME));
+    (void) pacerWait();
 
     clearScreen(COLOR_BLACK);
 
@@ -63,11 +79,9 @@ void startScreen(void)
             renderCharColor(ypos + (i * 64 * 1.6f), 200, 1.6f, COLOR_GOLD, title[i]);
     }
 
-    renderStrColorCentered(480, 0.5f, COLOR_PURPLE, "- press [ENTER] to start! -");
+    renderStrCachedCentered(480, 0.5f, COLOR_PURPLE, "- press [ENTER] to start! -");
 
-    SDL_RenderPresent(g_renderer);
-
-    prevt = currt;
+    presentScreen();
 }
 
 //
@@ -75,13 +89,8 @@ void startScreen(void)
 //
 void gameoverScreen(u32 score)
 {
-    // wait on spin
-    while (prevt && ((SDL_GetPerformanceCounter() * 1000) / ticksPerSecond) - prevt < MENU_FRAMETIME);
-
-    if (!prevt)
-        prevt = (SDL_GetPerformanceCounter() * 1000) / ticksPerSecond;
-
-    currt = (SDL_GetPerformanceCounter() * 1000) / ticksPerSecond;
+    pacerSetInterval(SDL_MS_TO_NS(MENU_FRAMETIME));
+    (void) pacerWait();
 
     clearScreen(COLOR_BLACK);
 
@@ -107,13 +116,25 @@ void gameoverScreen(u32 score)
             renderCharColor(ypos + (i * 128), 160, 2.0f, COLOR_GOLD, str[i]);
     }
 
-    renderStrColorFmtCentered(384, 1.0f, COLOR_PURPLE, "Score: %5ld", score);
-    renderStrColorCentered(544, 0.25f, COLOR_BLUE, "- press [ENTER] to exit -");
-    renderStrColorCentered(584, 0.25f, COLOR_BLUE, "- press [R] to reset -");
+    char text[RENDER_U64_MAX_DIGITS + 8] = "Score: ";
+
+    (void) renderFormatU64(text + 7, score, 5);
+
+    renderStrCachedCentered(384, 1.0f, COLOR_PURPLE, text);
+    renderStrCachedCentered(544, 0.25f, COLOR_BLUE, "- press [ENTER] to exit -");
+    renderStrCachedCentered(584, 0.25f, COLOR_BLUE, "- press [R] to reset -");
 
-    SDL_RenderPresent(g_renderer);
+    presentScreen();
+}
+
+// leave start or game over screen, simulation starts ticking
+void startGame(void)
+{
+    state = 1;
+    prevt = 0;
 
-    prevt = currt;
+    if (!simThread)
+        simThread = startSimThread();
 }
 
 SDL_AppResult handleInput(SDL_Keycode input)
@@ -131,7 +152,7 @@ SDL_AppResult handleInput(SDL_Keycode input)
         if (!state)
             return SDL_APP_SUCCESS;
         else if (state == 2)
-            state = 1;
+            startGame();
 
         break;
 
@@ -154,17 +175,68 @@ SDL_AppResult handleInput(SDL_Keycode input)
         toggleGodMode();
         break;
 
+    case SDLK_P:
+        profToggleOverlay();
+        break;
+
     case SDLK_R:
-        state = 1;
-        prevt = 0;
-        asciiResetAll();
-        initWorld();
+        // simulation ignores it while a replay drives the game
+        requestReset();
+        startGame();
         break;
     }
 
     return SDL_APP_CONTINUE;
 }
 
+//
+//  Command line, --record <file>, --replay <file> [--ff <tick>]
+//
+bool parseArgs(int argc, char** argv)
+{
+    const char* record = NULL;
+    const char* replay = NULL;
+    u64 ffTick = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!SDL_strcmp(argv[i], "--record") && i + 1 < argc)
+            record = argv[++i];
+        else if (!SDL_strcmp(argv[i], "--replay") && i + 1 < argc)
+            replay = argv[++i];
+        else if (!SDL_strcmp(argv[i], "--ff") && i + 1 < argc)
+            ffTick = SDL_strtoull(argv[++i], NULL, 10);
+        else {
+            SDL_Log("Usage: %s [--record <file>] [--replay <file> [--ff <tick>]]", argv[0]);
+            return 0;
+        }
+    }
+
+    if (record && replay) {
+        SDL_Log("Can't record and replay at the same time");
+        return 0;
+    }
+
+    if (record)
+        return replayStartRecording(record, getTickRate(), 0);
+
+    if (replay) {
+        u32 tickRate;
+        bool godMode;
+
+        if (!replayStartPlayback(replay, &tickRate, &godMode))
+            return 0;
+
+        setTickRate(tickRate);
+        setGodMode(godMode);
+        replaySetFastForward(ffTick);
+
+        // replay starts with the recorded game, skip start screen
+        state = 1;
+    }
+
+    return 1;
+}
+
 //
 //  SDL Init
 //
@@ -182,19 +254,33 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv)
 
     SDL_SetRenderScale(g_renderer, WINDOW_SCALE, WINDOW_SCALE);
 
+    updateFrameInterval();
+
     initRenderer();
 
     initAscii(ASCII_RENDER_MODE_2D);
 
+    // before first world init, so recording captures its seed
+    if (!parseArgs(argc, argv))
+        return SDL_APP_FAILURE;
+
     initWorld();
 
+    // replace seeded world with the recorded one
+    (void) applyReplayEvents();
+
     if (!loadTextures(textures, 3))
         return SDL_APP_FAILURE;
 
     if (!loadCharTextures("..\\resources\\ascii\\pressstart\\", 95))
         return SDL_APP_FAILURE;
 
-    ticksPerSecond = SDL_GetPerformanceFrequency();
+    initPacer(SDL_MS_TO_NS(MENU_FRAMETIME));
+
+    initProfiler();
+
+    if (state == 1)
+        startGame();
 
     return SDL_APP_CONTINUE;
 }
@@ -208,6 +294,10 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event)
         return SDL_APP_SUCCESS;
     else if (event->type == SDL_EVENT_KEY_DOWN)
         return handleInput(event->key.key);
+    else if (event->type == SDL_EVENT_RENDER_TARGETS_RESET)
+        renderTextCacheClear();     // baked strings are gone
+    else if (event->type == SDL_EVENT_WINDOW_DISPLAY_CHANGED || event->type == SDL_EVENT_DISPLAY_CURRENT_MODE_CHANGED)
+        updateFrameInterval();
 
     return SDL_APP_CONTINUE;
 }
@@ -219,26 +309,23 @@ SDL_AppResult SDL_AppIterate(void* appstate)
 {
     static u32 score = 0;
 
-    switch (state) {
-    case 1:
-        while (prevt && ((SDL_GetPerformanceCounter() * 1000) / ticksPerSecond) - prevt < FIXED_FRAMETIME);
+    u64 dt;
 
-        if (!prevt) {
-            prevt = (SDL_GetPerformanceCounter() * 1000) / ticksPerSecond;
+    profFrame();
 
-            updateWorld(0);
-
-            SDL_RenderPresent(g_renderer);
+    switch (state) {
+    case 1:
+        pacerSetInterval(frameNS);
 
-            return SDL_APP_CONTINUE;
-        }
+        currt = pacerWait();
 
-        currt = (SDL_GetPerformanceCounter() * 1000) / ticksPerSecond;
+        dt = prevt ? currt - prevt : 0;
 
-        if ((score = updateWorld(currt - prevt)) != GAME_CONTINUE)
+        // the simulation thread never waits for this, frames just draw its latest snapshot
+        if ((score = simThread ? renderSnapshot(dt) : updateWorld(dt)) != GAME_CONTINUE)
             state = 0;
 
-        SDL_RenderPresent(g_renderer);
+        presentScreen();
 
         prevt = currt;
 
@@ -249,10 +336,23 @@ SDL_AppResult SDL_AppIterate(void* appstate)
         break;
 
     default:
+        if (!simThread)
+            (void) simulateWorld(0);
+
+        // replay continues with next recorded game
+        if (getWorldResult() == GAME_CONTINUE) {
+            state = 1;
+            prevt = 0;
+            break;
+        }
+
         gameoverScreen(score);
         break;
     }
 
+    // scratch memory of this frame is no longer referenced
+    memFrameReset();
+
     return SDL_APP_CONTINUE;
 }
 
@@ -261,6 +361,16 @@ SDL_AppResult SDL_AppIterate(void* appstate)
 //
 void SDL_AppQuit(void* appstate, SDL_AppResult result)
 {
+    // before anything it touches is torn down
+    stopSimThread();
+
+    replayStop();
+
+    pacerLogStats();
+    profLogStats();
+
     cleanupRenderer();
     cleanupAscii();
+
+    memFrameDestroy();
 }
\ No newline at end of file
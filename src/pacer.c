@@ -0,0 +1,125 @@
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <pacer.h>
+#include <debug/rdebug.h>
+
+u64 g_pInterval = 0;
+u64 g_pDeadline = 0;
+u64 g_pStart = 0;
+u64 g_pScheduled = 0;
+
+pacerstats_t g_pStats;
+
+// initialize frame pacer
+void initPacer(u64 intervalNS)
+{
+    rAssert(intervalNS);
+
+    g_pInterval = intervalNS;
+
+    memset(&g_pStats, 0, sizeof(g_pStats));
+
+    pacerReset();
+}
+
+// restart schedule, next wait returns immediately
+void pacerReset(void)
+{
+    g_pDeadline = 0;
+    g_pStart = 0;
+    g_pScheduled = 0;
+}
+
+// change frame interval, restarts schedule if interval differs
+void pacerSetInterval(u64 intervalNS)
+{
+    rAssert(intervalNS);
+
+    if (intervalNS == g_pInterval)
+        return;
+
+    g_pInterval = intervalNS;
+
+    pacerReset();
+}
+
+u64 pacerGetInterval(void)
+{
+    return g_pInterval;
+}
+
+// sleep until next frame deadline, returns frame start timestamp in ns
+u64 pacerWait(void)
+{
+    rAssert(g_pInterval);
+
+    u64 now = SDL_GetTicksNS();
+
+    if (!g_pDeadline) {
+        g_pStart = now;
+        g_pScheduled = 0;
+        g_pDeadline = now + g_pInterval;
+
+        return now;
+    }
+
+    // sleep for the bulk of the interval, spin only for the rest
+    if (now + PACER_SPIN_NS + PACER_MIN_SLEEP_NS < g_pDeadline)
+        SDL_DelayPrecise(g_pDeadline - now - PACER_SPIN_NS);
+
+    while ((now = SDL_GetTicksNS()) < g_pDeadline);
+
+    u64 overshoot = now - g_pDeadline;
+
+    g_pStats.frames++;
+    g_pStats.overshootTotal += overshoot;
+
+    if (overshoot > g_pStats.overshootMax)
+        g_pStats.overshootMax = overshoot;
+
+    // next deadline is based on the schedule, not on wakeup time, so overshoot doesn't accumulate
+    g_pDeadline += g_pInterval;
+    g_pScheduled++;
+
+    if (now >= g_pDeadline) {
+        g_pStats.late++;
+
+        // more than a whole frame behind, drop missed frames instead of bursting to catch up
+        if (now >= g_pDeadline + g_pInterval) {
+            g_pDeadline = now + g_pInterval;
+            g_pStats.resyncs++;
+
+            // schedule restarts at now, dropped time is the caller's and must not show up as drift
+            g_pStart = now - g_pScheduled * g_pInterval;
+        }
+    }
+
+    g_pStats.drift = (i64) (now - g_pStart) - (i64) (g_pScheduled * g_pInterval);
+
+    return now;
+}
+
+void pacerGetStats(pacerstats_t* stats)
+{
+    rAssert(stats);
+
+    *stats = g_pStats;
+}
+
+void pacerLogStats(void)
+{
+    if (!g_pStats.frames)
+        return;
+
+    SDL_Log
+    (
+        "Pacer: %llu frames, %llu late, %llu resyncs, overshoot avg %llu ns max %llu ns, drift %lld ns",
+        g_pStats.frames,
+        g_pStats.late,
+        g_pStats.resyncs,
+        g_pStats.overshootTotal / g_pStats.frames,
+        g_pStats.overshootMax,
+        g_pStats.drift
+    );
+}
\ No newline at end of file
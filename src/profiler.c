@@ -0,0 +1,364 @@
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <profiler.h>
+#include <render.h>
+#include <pacer.h>
+#include <debug/rdebug.h>
+
+//
+//  Local types
+//
+typedef struct profframe_s {
+    u32 frameNS;                    // wall time from frame start to next frame start, includes pacing
+    u32 zoneNS[PROF_MAX_ZONES];     // summed over all calls in frame
+    u32 counters[PROF_MAX_COUNTERS];
+} profframe_t;
+
+const char* g_profZoneNames[PROF_MAX_ZONES] = {
+    "updateWorld",
+    "renderClouds",
+    "renderPipes",
+    "renderBird",
+    "renderBuf2D",
+    "present"
+};
+
+const char* g_profCounterNames[PROF_MAX_COUNTERS] = {
+    "queue chars",
+    "queue bytes",
+    "queue spills",
+    "culled objects",
+    "draw calls",
+    "state changes",
+    "text hits",
+    "text misses"
+};
+
+// history ring, g_profFrameIdx is next slot to write
+profframe_t g_profFrames[PROF_MAX_FRAMES];
+u32 g_profFrameIdx = 0;
+u32 g_profFrameCount = 0;
+
+// current frame
+u64 g_profFrameStart = 0;
+u64 g_profZoneTicks[PROF_MAX_ZONES];
+u8 g_profZoneDepth[PROF_MAX_ZONES];
+u32 g_profCounters[PROF_MAX_COUNTERS];
+
+// open zones
+u64 g_profStackStart[PROF_MAX_DEPTH];
+u32 g_profStackZone[PROF_MAX_DEPTH];
+u32 g_profDepth = 0;
+
+u64 g_profFreq = 1;
+
+bool g_profOverlay = 0;
+
+//
+//  Local functions
+//
+static inline u64 ticksToNS(u64 ticks)
+{
+    return ticks * SDL_NS_PER_SECOND / g_profFreq;
+}
+
+static int SDLCALL compareU32(const void* a, const void* b)
+{
+    u32 x = *(const u32*) a;
+    u32 y = *(const u32*) b;
+
+    return (x > y) - (x < y);
+}
+
+// value of one frame, zone, PROF_MAX_ZONES for frame time or PROF_MAX_ZONES + 1 + counter
+static inline u32 frameValue(const profframe_t* frame, u32 idx)
+{
+    if (idx < PROF_MAX_ZONES)
+        return frame->zoneNS[idx];
+
+    if (idx == PROF_MAX_ZONES)
+        return frame->frameNS;
+
+    return frame->counters[idx - PROF_MAX_ZONES - 1];
+}
+
+// stats over history of one value per frame, see frameValue
+static void computeStats(u32 zone, profstats_t* stats)
+{
+    static u32 samples[PROF_MAX_FRAMES];
+
+    memset(stats, 0, sizeof(profstats_t));
+
+    if (!g_profFrameCount)
+        return;
+
+    u64 total = 0;
+
+    for (u32 i = 0; i < g_profFrameCount; i++) {
+        samples[i] = frameValue(g_profFrames + i, zone);
+        total += samples[i];
+    }
+
+    SDL_qsort(samples, g_profFrameCount, sizeof(u32), compareU32);
+
+    stats->frames = g_profFrameCount;
+    stats->min = samples[0];
+    stats->max = samples[g_profFrameCount - 1];
+    stats->avg = total / g_profFrameCount;
+    stats->p50 = samples[(g_profFrameCount - 1) / 2];
+    stats->p99 = samples[(g_profFrameCount - 1) * 99 / 100];
+}
+
+//
+//  Public functions
+//
+void initProfiler(void)
+{
+    memset(g_profFrames, 0, sizeof(g_profFrames));
+    memset(g_profZoneTicks, 0, sizeof(g_profZoneTicks));
+    memset(g_profZoneDepth, 0, sizeof(g_profZoneDepth));
+    memset(g_profCounters, 0, sizeof(g_profCounters));
+
+    g_profFrameIdx = 0;
+    g_profFrameCount = 0;
+    g_profFrameStart = 0;
+    g_profDepth = 0;
+
+    g_profFreq = SDL_GetPerformanceFrequency();
+}
+
+void profBegin_Implementation(u32 zone)
+{
+    rAssert(zone < PROF_MAX_ZONES);
+    rAssert(g_profDepth < PROF_MAX_DEPTH);
+
+    g_profZoneDepth[zone] = g_profDepth;
+    g_profStackZone[g_profDepth] = zone;
+    g_profStackStart[g_profDepth] = SDL_GetPerformanceCounter();
+
+    g_profDepth++;
+}
+
+void profEnd_Implementation(u32 zone)
+{
+    u64 now = SDL_GetPerformanceCounter();
+
+    rAssert(g_profDepth);
+    rAssertMsg(g_profStackZone[g_profDepth - 1] == zone, "Profiler zones closed out of order");
+
+    g_profDepth--;
+    g_profZoneTicks[zone] += now - g_profStackStart[g_profDepth];
+}
+
+void profCount_Implementation(u32 counter, u32 n)
+{
+    rAssert(counter < PROF_MAX_COUNTERS);
+
+    g_profCounters[counter] += n;
+}
+
+// close current frame and start next one, call once per frame outside of any zone
+void profFrame(void)
+{
+    u64 now = SDL_GetPerformanceCounter();
+
+    rAssert(!g_profDepth);
+
+    if (g_profFrameStart) {
+        profframe_t* frame = g_profFrames + g_profFrameIdx;
+
+        frame->frameNS = (u32) SDL_min(ticksToNS(now - g_profFrameStart), SDL_MAX_UINT32);
+
+        for (u32 i = 0; i < PROF_MAX_ZONES; i++)
+            frame->zoneNS[i] = (u32) SDL_min(ticksToNS(g_profZoneTicks[i]), SDL_MAX_UINT32);
+
+        memcpy(frame->counters, g_profCounters, sizeof(g_profCounters));
+
+        g_profFrameIdx = (g_profFrameIdx + 1) % PROF_MAX_FRAMES;
+
+        if (g_profFrameCount < PROF_MAX_FRAMES)
+            g_profFrameCount++;
+    }
+
+    memset(g_profZoneTicks, 0, sizeof(g_profZoneTicks));
+    memset(g_profCounters, 0, sizeof(g_profCounters));
+
+    g_profFrameStart = now;
+}
+
+void profToggleOverlay(void)
+{
+    g_profOverlay = !g_profOverlay;
+}
+
+// draw per zone min / avg / p99 and frame time graph, no-op unless toggled on
+void profDrawOverlay(void)
+{
+    if (!g_profOverlay)
+        return;
+
+    static SDL_FRect okBars[PROF_MAX_FRAMES];
+    static SDL_FRect lateBars[PROF_MAX_FRAMES];
+
+    const f32 scale = 0.1875f;      // 12 px glyphs
+    const f32 xpos = 23.0f;
+    const f32 ypos = 60.0f;
+    const f32 rowHeight = 16.0f;
+    const f32 graphHeight = 100.0f;
+
+    profstats_t stats;
+    f32 y = ypos + 8.0f;
+
+    renderSetLayer(RENDER_LAYER_OVERLAY);
+
+    renderRectangleColor(xpos, ypos, 700.0f, 8.0f + rowHeight * (PROF_MAX_ZONES + PROF_MAX_COUNTERS + 3) + graphHeight + 16.0f, COLOR_D_GRAY);
+
+    renderSetLayer(RENDER_LAYER_OVERLAY_TEXT);
+
+    renderStrCached(xpos + 8.0f, y, scale, COLOR_L_YELLOW, "zone                 min ms   avg ms   p99 ms");
+
+    for (u32 i = 0; i < PROF_MAX_ZONES; i++) {
+        y += rowHeight;
+
+        computeStats(i, &stats);
+
+        renderStrColorFmt
+        (
+            xpos + 8.0f + g_profZoneDepth[i] * 24.0f,
+            y,
+            scale,
+            COLOR_WHITE,
+            "%-*s %8.3f %8.3f %8.3f",
+            19 - g_profZoneDepth[i] * 2,
+            g_profZoneNames[i],
+            stats.min / 1e6,
+            stats.avg / 1e6,
+            stats.p99 / 1e6
+        );
+    }
+
+    y += rowHeight;
+
+    computeStats(PROF_MAX_ZONES, &stats);
+
+    renderStrColorFmt
+    (
+        xpos + 8.0f,
+        y,
+        scale,
+        COLOR_L_GREEN,
+        "%-19s %8.3f %8.3f %8.3f",
+        "frame",
+        stats.min / 1e6,
+        stats.avg / 1e6,
+        stats.p99 / 1e6
+    );
+
+    y += rowHeight;
+
+    renderStrCached(xpos + 8.0f, y, scale, COLOR_L_YELLOW, "counter                  min      avg      max");
+
+    for (u32 i = 0; i < PROF_MAX_COUNTERS; i++) {
+        y += rowHeight;
+
+        computeStats(PROF_MAX_ZONES + 1 + i, &stats);
+
+        renderStrColorFmt(xpos + 8.0f, y, scale, COLOR_AZURE, "%-19s %8llu %8llu %8llu", g_profCounterNames[i], stats.min, stats.avg, stats.max);
+    }
+
+    // graph spans two frame budgets, budget line in the middle, oldest frame on the left
+    f32 budget = (f32) pacerGetInterval();
+    f32 base = y + rowHeight + 8.0f + graphHeight;
+    u32 numOk = 0, numLate = 0;
+
+    if (budget <= 0.0f)
+        budget = (f32) SDL_MS_TO_NS(RENDER_FRAMETIME);
+
+    for (u32 i = 0; i < g_profFrameCount; i++) {
+        u32 idx = (g_profFrameIdx + PROF_MAX_FRAMES - g_profFrameCount + i) % PROF_MAX_FRAMES;
+        f32 ns = (f32) g_profFrames[idx].frameNS;
+        f32 h = SDL_min(ns / (2.0f * budget), 1.0f) * graphHeight;
+
+        SDL_FRect* bar = ns > budget * 1.1f ? lateBars + numLate++ : okBars + numOk++;
+
+        bar->x = xpos + 8.0f + (f32) i * 2.5f;
+        bar->y = base - h;
+        bar->w = 2.0f;
+        bar->h = h;
+    }
+
+    setColor(COLOR_L_GREEN);
+    renderRectangles(okBars, numOk);
+
+    setColor(COLOR_RED);
+    renderRectangles(lateBars, numLate);
+
+    // budget line crosses the bars
+    renderSetLayer(RENDER_LAYER_OVERLAY_TOP);
+
+    renderRectangleColor(xpos + 8.0f, base - graphHeight / 2.0f, PROF_MAX_FRAMES * 2.5f, 1.0f, COLOR_L_YELLOW);
+}
+
+// stats over frames in history, ns
+void profGetZoneStats(u32 zone, profstats_t* stats)
+{
+    rAssert(zone < PROF_MAX_ZONES);
+    rAssert(stats);
+
+    computeStats(zone, stats);
+}
+
+void profGetFrameStats(profstats_t* stats)
+{
+    rAssert(stats);
+
+    computeStats(PROF_MAX_ZONES, stats);
+}
+
+// stats of per frame sums, counts instead of ns
+void profGetCounterStats(u32 counter, profstats_t* stats)
+{
+    rAssert(counter < PROF_MAX_COUNTERS);
+    rAssert(stats);
+
+    computeStats(PROF_MAX_ZONES + 1 + counter, stats);
+}
+
+void profLogStats(void)
+{
+    if (!g_profFrameCount)
+        return;
+
+    profstats_t stats;
+
+    computeStats(PROF_MAX_ZONES, &stats);
+
+    SDL_Log
+    (
+        "Profiler: last %lu frames, frame min %.3f ms avg %.3f ms p99 %.3f ms",
+        stats.frames,
+        stats.min / 1e6,
+        stats.avg / 1e6,
+        stats.p99 / 1e6
+    );
+
+    for (u32 i = 0; i < PROF_MAX_ZONES; i++) {
+        computeStats(i, &stats);
+
+        SDL_Log
+        (
+            "  %-12s min %.3f ms avg %.3f ms p99 %.3f ms",
+            g_profZoneNames[i],
+            stats.min / 1e6,
+            stats.avg / 1e6,
+            stats.p99 / 1e6
+        );
+    }
+
+    for (u32 i = 0; i < PROF_MAX_COUNTERS; i++) {
+        computeStats(PROF_MAX_ZONES + 1 + i, &stats);
+
+        SDL_Log("  %-12s avg %llu max %llu per frame", g_profCounterNames[i], stats.avg, stats.max);
+    }
+}
\ No newline at end of file
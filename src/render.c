@@ -1,20 +1,489 @@
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <SDL3/SDL.h>
 
 #include <render.h>
+#include <profiler.h>
 #include <debug/rdebug.h>
+#include <debug/memtrack.h>
 
 texture_t r_textures[MAX_TEXTURES];
-SDL_Texture* r_asciitex[MAX_ASCII_TEXTURES];
-u32 r_asciicolors[MAX_ASCII_TEXTURES];
+
+// all ascii glyphs packed into a single atlas texture
+SDL_Texture* r_asciiatlas = NULL;
+SDL_FRect r_asciiuv[MAX_ASCII_TEXTURES];
+
+//
+//  Local types
+//
+#define RENDER_CMD_FILL     0
+#define RENDER_CMD_OUTLINE  1
+#define RENDER_CMD_QUAD     2   // textured quad, glyph if texture is RENDER_TEX_ATLAS
+
+#define RENDER_TEX_ATLAS    MAX_TEXTURES
+#define RENDER_TEX_TEXT     (MAX_TEXTURES + 1)  // text cache, param is the slot
+
+// one recorded draw, turned into SDL calls when the frame is flushed
+typedef struct rendercmd_s {
+    SDL_FRect dst;
+    Uint32 color;
+    Uint16 rotation;    // degrees, clockwise around dst center
+    Uint8  type;
+    Uint8  layer;
+    Uint8  texture;
+    Uint8  param;       // char index into atlas uvs for glyphs, SDL_FlipMode for textures
+} rendercmd_t;
+
+// string baked into one row of the text cache texture
+typedef struct textslot_s {
+    char text[RENDER_TEXT_CACHE_LEN];
+    u32 len;
+    Uint32 hash;
+    f32 scale;
+    Uint32 color;
+    u64 lastUsed;       // r_textclock at last draw, 0 if slot is empty
+    u64 frame;          // r_textframe at last draw, slot is sampled by recorded commands until flushed
+} textslot_t;
+
+// quads of a flush run, submitted with a single geometry call per batch
+SDL_Vertex r_quadverts[RENDER_MAX_BATCH_GLYPHS * 4];
+int r_quadindices[RENDER_MAX_BATCH_GLYPHS * 6];
+
+SDL_FRect r_rects[RENDER_MAX_BATCH_RECTS];
+
+// frame command list, sort keys are layer, texture and color above the 16 bit command index
+SDL_COMPILE_TIME_ASSERT(render_cmd_index, RENDER_MAX_COMMANDS <= 0x10000);
+
+rendercmd_t r_cmds[RENDER_MAX_COMMANDS];
+Uint64 r_cmdorder[RENDER_MAX_COMMANDS * 2];
+u32 r_cmdcount = 0;
+
+u32 r_layer = RENDER_LAYER_HUD;
+u32 r_drawcolor = COLOR_BLACK;
+
+bool r_clear = 0;
+u32 r_clearcolor = COLOR_BLACK;
+
+renderstats_t r_stats;
+
+// text cache, texture is created on first use
+SDL_Texture* r_textatlas = NULL;
+SDL_FRect r_textuv[RENDER_TEXT_SLOTS];
+textslot_t r_textslots[RENDER_TEXT_SLOTS];
+u64 r_textclock = 0;
+u64 r_textframe = 1;
+bool r_textfailed = 0;      // renderer has no target textures, cached strings are drawn glyph by glyph
+
+static const char r_digitpairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+//
+//  Local functions
+//
+
+// list full, draw what is there so far, layering across the early flush is lost
+static rendercmd_t* recordCommand(Uint8 type, u32 layer)
+{
+    if (r_cmdcount >= RENDER_MAX_COMMANDS) {
+        r_stats.overflows++;
+        renderFlush();
+    }
+
+    rendercmd_t* cmd = r_cmds + r_cmdcount++;
+
+    cmd->rotation = 0;
+    cmd->type = type;
+    cmd->layer = (Uint8) layer;
+    cmd->texture = 0;
+    cmd->param = 0;
+
+    r_stats.commands++;
+
+    return cmd;
+}
+
+static void recordTexture(i16 xpos, i16 ypos, u16 scale, u16 rotation, SDL_FlipMode flip, u32 textureID)
+{
+    rAssert(scale);
+    rAssert(textureID < MAX_TEXTURES);
+    rAssert(r_textures[textureID].sdltex);
+
+    rendercmd_t* cmd = recordCommand(RENDER_CMD_QUAD, r_layer);
+
+    cmd->dst = (SDL_FRect) {
+        (f32) xpos,
+        (f32) ypos,
+        (f32) r_textures[textureID].width * scale,
+        (f32) r_textures[textureID].height * scale
+    };
+
+    cmd->color = r_textures[textureID].color;
+    cmd->rotation = rotation % 360;
+    cmd->texture = (Uint8) textureID;
+    cmd->param = (Uint8) flip;
+}
+
+static void setDrawColor(Uint32 color, Uint32* current, bool* valid)
+{
+    if (*valid && *current == color)
+        return;
+
+    SDL_SetRenderDrawColor(g_renderer, color >> 24, color >> 16, color >> 8, 255);
+
+    *current = color;
+    *valid = 1;
+
+    r_stats.stateChanges++;
+}
+
+// calls the list would have taken drawn in record order, one color set per rect and a glyph batch flush before every other draw
+static void countImmediate(void)
+{
+    i32 bound = -1;
+    u32 glyphs = 0;
+
+    if (r_clear) {
+        r_stats.immediateStateChanges++;
+        r_stats.immediateDrawCalls++;
+    }
+
+    for (u32 i = 0; i < r_cmdcount; i++) {
+        const rendercmd_t* cmd = r_cmds + i;
+        i32 texture = cmd->type == RENDER_CMD_QUAD ? cmd->texture : -1;
+
+        if (texture == RENDER_TEX_ATLAS && glyphs && glyphs < RENDER_MAX_BATCH_GLYPHS) {
+            glyphs++;
+            continue;
+        }
+
+        if (glyphs) {
+            r_stats.immediateDrawCalls++;
+            glyphs = 0;
+        }
+
+        if (bound != texture)
+            r_stats.immediateStateChanges++;
+
+        bound = texture;
+
+        if (texture == RENDER_TEX_ATLAS) {
+            glyphs = 1;
+            continue;
+        }
+
+        if (texture == -1)
+            r_stats.immediateStateChanges++;
+
+        r_stats.immediateDrawCalls++;
+    }
+
+    if (glyphs)
+        r_stats.immediateDrawCalls++;
+}
+
+// stable lsd radix sort over the key bytes, passes where every command has the same byte are skipped
+static const Uint64* sortCommands(void)
+{
+    u32 counts[6][256];
+    Uint64* src = r_cmdorder;
+    Uint64* dst = r_cmdorder + RENDER_MAX_COMMANDS;
+
+    if (!r_cmdcount)
+        return src;
+
+    memset(counts, 0, sizeof(counts));
+
+    for (u32 i = 0; i < r_cmdcount; i++) {
+        const rendercmd_t* cmd = r_cmds + i;
+
+        Uint64 group = cmd->type == RENDER_CMD_QUAD ? 2 + cmd->texture : cmd->type;
+        Uint64 color = cmd->type == RENDER_CMD_QUAD ? 0 : cmd->color;
+        Uint64 key = (Uint64) cmd->layer << 40 | group << 32 | color;
+
+        src[i] = key << 16 | i;
+
+        for (u32 b = 0; b < 6; b++)
+            counts[b][(key >> (b * 8)) & 0xff]++;
+    }
+
+    for (u32 pass = 0; pass < 6; pass++) {
+        u32 shift = 16 + pass * 8;
+
+        if (counts[pass][(src[0] >> shift) & 0xff] == r_cmdcount)
+            continue;
+
+        u32 offset = 0;
+
+        for (u32 b = 0; b < 256; b++) {
+            u32 c = counts[pass][b];
+            counts[pass][b] = offset;
+            offset += c;
+        }
+
+        for (u32 i = 0; i < r_cmdcount; i++)
+            dst[counts[pass][(src[i] >> shift) & 0xff]++] = src[i];
+
+        Uint64* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+static inline SDL_FColor toFColor(Uint32 color)
+{
+    return (SDL_FColor) {(u8) (color >> 24) / 255.0f, (u8) (color >> 16) / 255.0f, (u8) (color >> 8) / 255.0f, 1.0f};
+}
+
+static inline void writeQuad(SDL_Vertex* v, const SDL_FRect* dst, f32 u0, f32 v0, f32 u1, f32 v1, SDL_FColor color)
+{
+    f32 x0 = dst->x;
+    f32 y0 = dst->y;
+    f32 x1 = x0 + dst->w;
+    f32 y1 = y0 + dst->h;
+
+    v[0].position.x = x0; v[0].position.y = y0; v[0].tex_coord.x = u0; v[0].tex_coord.y = v0;
+    v[1].position.x = x1; v[1].position.y = y0; v[1].tex_coord.x = u1; v[1].tex_coord.y = v0;
+    v[2].position.x = x1; v[2].position.y = y1; v[2].tex_coord.x = u1; v[2].tex_coord.y = v1;
+    v[3].position.x = x0; v[3].position.y = y1; v[3].tex_coord.x = u0; v[3].tex_coord.y = v1;
+
+    v[0].color = color;
+    v[1].color = color;
+    v[2].color = color;
+    v[3].color = color;
+}
+
+static SDL_Texture* commandTexture(Uint8 texture)
+{
+    if (texture == RENDER_TEX_ATLAS)
+        return r_asciiatlas;
+
+    if (texture == RENDER_TEX_TEXT)
+        return r_textatlas;
+
+    return r_textures[texture].sdltex;
+}
+
+// quads of one texture, flip swaps uvs and rotation turns the corners, so every quad fits one geometry call
+static void drawQuads(const Uint64* order, u32 count)
+{
+    const rendercmd_t* first = r_cmds + (Uint16) order[0];
+    SDL_Texture* texture = commandTexture(first->texture);
+
+    rAssert(texture);
+
+    Uint32 color = ~first->color;
+    SDL_FColor fcolor = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    u32 quads = 0;
+
+    for (u32 i = 0; i < count; i++) {
+        const rendercmd_t* cmd = r_cmds + (Uint16) order[i];
+
+        // only convert color if necessary
+        if (cmd->color != color) {
+            fcolor = toFColor(cmd->color);
+            color = cmd->color;
+        }
+
+        f32 u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+
+        if (cmd->texture == RENDER_TEX_ATLAS || cmd->texture == RENDER_TEX_TEXT) {
+            const SDL_FRect* uv = cmd->texture == RENDER_TEX_ATLAS ? r_asciiuv + cmd->param : r_textuv + cmd->param;
+
+            u0 = uv->x; v0 = uv->y; u1 = uv->w; v1 = uv->h;
+        } else {
+            if (cmd->param & SDL_FLIP_HORIZONTAL) { u0 = 1.0f; u1 = 0.0f; }
+            if (cmd->param & SDL_FLIP_VERTICAL) { v0 = 1.0f; v1 = 0.0f; }
+        }
+
+        SDL_Vertex* v = r_quadverts + quads * 4;
+
+        writeQuad(v, &cmd->dst, u0, v0, u1, v1, fcolor);
+
+        if (cmd->rotation) {
+            f32 a = (f32) cmd->rotation * (SDL_PI_F / 180.0f);
+            f32 c = cosf(a), s = sinf(a);
+            f32 cx = cmd->dst.x + cmd->dst.w * 0.5f;
+            f32 cy = cmd->dst.y + cmd->dst.h * 0.5f;
+
+            for (u32 k = 0; k < 4; k++) {
+                f32 dx = v[k].position.x - cx;
+                f32 dy = v[k].position.y - cy;
+
+                v[k].position.x = cx + dx * c - dy * s;
+                v[k].position.y = cy + dx * s + dy * c;
+            }
+        }
+
+        if (++quads == RENDER_MAX_BATCH_GLYPHS || i + 1 == count) {
+            if (!SDL_RenderGeometry(g_renderer, texture, r_quadverts, quads * 4, r_quadindices, quads * 6))
+                SDL_Log("Failed to render quad batch: %s", SDL_GetError());
+
+            r_stats.drawCalls++;
+            quads = 0;
+        }
+    }
+}
+
+// rects of one color, filled or outlined
+static void drawRects(const Uint64* order, u32 count, Uint8 type)
+{
+    for (u32 first = 0; first < count; first += RENDER_MAX_BATCH_RECTS) {
+        u32 n = SDL_min(count - first, RENDER_MAX_BATCH_RECTS);
+
+        for (u32 i = 0; i < n; i++)
+            r_rects[i] = r_cmds[(Uint16) order[first + i]].dst;
+
+        if (type == RENDER_CMD_FILL)
+            SDL_RenderFillRects(g_renderer, r_rects, n);
+        else
+            SDL_RenderRects(g_renderer, r_rects, n);
+
+        r_stats.drawCalls++;
+    }
+}
+
+static bool createTextAtlas(void)
+{
+    if (r_textatlas)
+        return 1;
+
+    if (r_textfailed)
+        return 0;
+
+    r_textatlas = SDL_CreateTexture(g_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, RENDER_TEXT_ATLAS_SIZE, RENDER_TEXT_ATLAS_SIZE);
+
+    if (!r_textatlas) {
+        SDL_Log("Failed to create text cache texture, strings are drawn uncached: %s", SDL_GetError());
+        r_textfailed = 1;
+        return 0;
+    }
+
+    SDL_SetTextureScaleMode(r_textatlas, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(r_textatlas, SDL_BLENDMODE_BLEND);
+
+    return 1;
+}
+
+static textslot_t* findTextSlot(const char* str, u32 len, Uint32 hash, f32 scale, u32 color)
+{
+    for (u32 i = 0; i < RENDER_TEXT_SLOTS; i++) {
+        textslot_t* slot = r_textslots + i;
+
+        if (slot->lastUsed && slot->hash == hash && slot->len == len && slot->scale == scale && slot->color == color && !memcmp(slot->text, str, len))
+            return slot;
+    }
+
+    return NULL;
+}
+
+// empty slot, else least recently drawn one, slots drawn since the last flush are still sampled by recorded commands
+static textslot_t* evictTextSlot(void)
+{
+    textslot_t* victim = NULL;
+
+    for (u32 i = 0; i < RENDER_TEXT_SLOTS; i++) {
+        textslot_t* slot = r_textslots + i;
+
+        if (!slot->lastUsed)
+            return slot;
+
+        if (slot->frame == r_textframe)
+            continue;
+
+        if (!victim || slot->lastUsed < victim->lastUsed)
+            victim = slot;
+    }
+
+    if (victim)
+        r_stats.textEvictions++;
+
+    return victim;
+}
+
+// draw glyphs into slot row with the same placement as renderStrColor, copied without blending so the row holds exactly the glyphs
+static bool bakeText(u32 slot, const char* str, u32 len, f32 scale, u32 color)
+{
+    SDL_Texture* target = SDL_GetRenderTarget(g_renderer);
+
+    if (!SDL_SetRenderTarget(g_renderer, r_textatlas)) {
+        SDL_Log("Failed to bake text: %s", SDL_GetError());
+        return 0;
+    }
+
+    const f32 top = (f32) (slot * RENDER_TEXT_SLOT_HEIGHT);
+    const SDL_FRect row = {0.0f, top, RENDER_TEXT_ATLAS_SIZE, RENDER_TEXT_SLOT_HEIGHT};
+    const SDL_FColor fcolor = toFColor(color);
+
+    // transparent row, replaces whatever string was there before
+    SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(g_renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(g_renderer, &row);
+
+    u32 quads = 0;
+
+    for (u32 i = 0; i < len; i++) {
+        if (str[i] < 33 || str[i] > 125)
+            continue;
+
+        const SDL_FRect* uv = r_asciiuv + (str[i] - 32);
+        const SDL_FRect dst = {(f32) (i16) (i * 64 * scale), top, RENDER_GLYPH_SIZE * scale, RENDER_GLYPH_SIZE * scale};
+
+        writeQuad(r_quadverts + quads * 4, &dst, uv->x, uv->y, uv->w, uv->h, fcolor);
+
+        quads++;
+    }
+
+    if (quads) {
+        SDL_SetTextureBlendMode(r_asciiatlas, SDL_BLENDMODE_NONE);
+
+        if (!SDL_RenderGeometry(g_renderer, r_asciiatlas, r_quadverts, quads * 4, r_quadindices, quads * 6))
+            SDL_Log("Failed to bake text: %s", SDL_GetError());
+
+        SDL_SetTextureBlendMode(r_asciiatlas, SDL_BLENDMODE_BLEND);
+    }
+
+    SDL_SetRenderTarget(g_renderer, target);
+
+    // two target switches and the clear color
+    r_stats.drawCalls += quads ? 2 : 1;
+    r_stats.stateChanges += 3;
+
+    return 1;
+}
 
 // initialize renderer
 void initRenderer(void)
 {
     memset(r_textures, 0, sizeof(r_textures));
-    memset(r_asciitex, 0, sizeof(r_asciitex));
-    memset(r_asciicolors, 1, sizeof(r_asciicolors));
+    memset(r_asciiuv, 0, sizeof(r_asciiuv));
+
+    memset(&r_stats, 0, sizeof(r_stats));
+
+    r_asciiatlas = NULL;
+    r_cmdcount = 0;
+    r_layer = RENDER_LAYER_HUD;
+    r_clear = 0;
+
+    r_textatlas = NULL;
+    r_textfailed = 0;
+    renderTextCacheClear();
+
+    // quad indices never change, only vertices are written per frame
+    for (u32 i = 0; i < RENDER_MAX_BATCH_GLYPHS; i++) {
+        r_quadindices[i * 6 + 0] = i * 4 + 0;
+        r_quadindices[i * 6 + 1] = i * 4 + 1;
+        r_quadindices[i * 6 + 2] = i * 4 + 2;
+        r_quadindices[i * 6 + 3] = i * 4 + 2;
+        r_quadindices[i * 6 + 4] = i * 4 + 3;
+        r_quadindices[i * 6 + 5] = i * 4 + 0;
+    }
 }
 
 // cleanup renderer
@@ -25,26 +494,40 @@ void cleanupRenderer(void)
             SDL_DestroyTexture(r_textures[i].sdltex);
     }
 
-    for (u8 i = 0; i < MAX_ASCII_TEXTURES; i++) {
-        if (r_asciitex[i])
-            SDL_DestroyTexture(r_asciitex[i]);
-    }
+    if (r_asciiatlas)
+        SDL_DestroyTexture(r_asciiatlas);
+
+    if (r_textatlas)
+        SDL_DestroyTexture(r_textatlas);
+
+    r_asciiatlas = NULL;
+    r_textatlas = NULL;
+    r_textfailed = 0;
+    r_cmdcount = 0;
+
+    renderTextCacheClear();
 }
 
-// clear screen and set background color
+// clear screen and set background color, commands recorded so far would be drawn over and are dropped
 void clearScreen(u32 color)
 {
-    setColor(color);
-
-    SDL_RenderClear(g_renderer);
+    r_cmdcount = 0;
+    r_clear = 1;
+    r_clearcolor = color;
 }
 
 // set color for simple drawing operations
 void setColor(u32 color)
 {
-    rAssert(g_renderer);
+    r_drawcolor = color;
+}
 
-    SDL_SetRenderDrawColor(g_renderer, color >> 24, color >> 16, color >> 8, 255);
+// commands recorded from here on are drawn above lower layers, order within a layer is not kept
+void renderSetLayer(u32 layer)
+{
+    rAssert(layer < RENDER_LAYERS);
+
+    r_layer = layer;
 }
 
 void renderRectangleColor(f32 xpos, f32 ypos, f32 width, f32 height, u32 color)
@@ -56,22 +539,27 @@ void renderRectangleColor(f32 xpos, f32 ypos, f32 width, f32 height, u32 color)
 
 void renderRectangle(f32 xpos, f32 ypos, f32 width, f32 height)
 {
-    rAssert(g_renderer);
+    rendercmd_t* cmd = recordCommand(RENDER_CMD_FILL, r_layer);
 
-    SDL_FRect rect = {xpos, ypos, width, height};
-
-    SDL_RenderFillRect(g_renderer, &rect);
+    cmd->dst = (SDL_FRect) {xpos, ypos, width, height};
+    cmd->color = r_drawcolor;
 }
 
-void renderHitbox(f32 xpos, f32 ypos, f32 width, f32 height)
+void renderRectangles(const SDL_FRect* rects, u32 count)
 {
-    rAssert(g_renderer);
+    rAssert(rects || !count);
 
-    setColor(COLOR_HITBOXES);
+    for (u32 i = 0; i < count; i++)
+        renderRectangle(rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+}
 
-    SDL_FRect rect = {xpos, ypos, width, height};
+// hitboxes are always on their own layer above the world
+void renderHitbox(f32 xpos, f32 ypos, f32 width, f32 height)
+{
+    rendercmd_t* cmd = recordCommand(RENDER_CMD_OUTLINE, RENDER_LAYER_HITBOXES);
 
-    SDL_RenderRect(g_renderer, &rect);
+    cmd->dst = (SDL_FRect) {xpos, ypos, width, height};
+    cmd->color = COLOR_HITBOXES;
 }
 
 // load multiple textures
@@ -114,6 +602,7 @@ bool loadTexture(const char* path, bool noInterpolation, u8 textureID)
 
     r_textures[textureID].width = surf->w;
     r_textures[textureID].height = surf->h;
+    r_textures[textureID].color = COLOR_WHITE;
     r_textures[textureID].sdltex = SDL_CreateTextureFromSurface(g_renderer, surf);
 
     if (!r_textures[textureID].sdltex) {
@@ -129,14 +618,27 @@ bool loadTexture(const char* path, bool noInterpolation, u8 textureID)
     return 1;
 }
 
+// load chars and pack them into one atlas texture
 bool loadCharTextures(const char* path, u32 numChars)
 {
     rAssert(path);
+    rAssert(g_renderer);
+    rAssert(numChars <= MAX_ASCII_TEXTURES);
 
     const char* bpath = SDL_GetBasePath();
 
+    const u32 rows = (numChars + RENDER_ATLAS_COLS - 1) / RENDER_ATLAS_COLS;
+    const u32 atlasw = RENDER_ATLAS_COLS * RENDER_GLYPH_SIZE;
+    const u32 atlash = rows * RENDER_GLYPH_SIZE;
+
+    SDL_Surface* atlas = SDL_CreateSurface(atlasw, atlash, SDL_PIXELFORMAT_RGBA32);
     SDL_Surface* surf;
 
+    if (!atlas) {
+        SDL_Log("Failed to create glyph atlas: %s", SDL_GetError());
+        return 0;
+    }
+
     char pbuf[128];
 
     for (u32 i = 0; i < numChars; i++) {
@@ -146,128 +648,291 @@ bool loadCharTextures(const char* path, u32 numChars)
 
         if (!surf) {
             SDL_Log("Failed to load char %d: %s", i + 1, SDL_GetError());
+            SDL_DestroySurface(atlas);
             return 0;
         }
 
-        // SDL_Log("Loaded char %d: %ldx%ld", i + 1, surf->w, surf->h);
+        SDL_Rect dst = {
+            (i % RENDER_ATLAS_COLS) * RENDER_GLYPH_SIZE,
+            (i / RENDER_ATLAS_COLS) * RENDER_GLYPH_SIZE,
+            RENDER_GLYPH_SIZE,
+            RENDER_GLYPH_SIZE
+        };
 
-        r_asciitex[i] = SDL_CreateTextureFromSurface(g_renderer, surf);
-        r_asciicolors[i] = COLOR_WHITE;
+        // copy alpha as is instead of blending onto the empty atlas
+        SDL_SetSurfaceBlendMode(surf, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(surf, NULL, atlas, &dst);
 
-        if (!r_asciitex[i]) {
-            SDL_Log("Failed to create static texture for char %d: %s", i + 1, SDL_GetError());
-            return 0;
-        }
-
-        SDL_SetTextureScaleMode(r_asciitex[i], SDL_SCALEMODE_NEAREST);
+        // uv rect stored as x0, y0, x1, y1
+        r_asciiuv[i].x = (f32) dst.x / atlasw;
+        r_asciiuv[i].y = (f32) dst.y / atlash;
+        r_asciiuv[i].w = (f32) (dst.x + dst.w) / atlasw;
+        r_asciiuv[i].h = (f32) (dst.y + dst.h) / atlash;
 
         SDL_DestroySurface(surf);
     }
 
+    r_asciiatlas = SDL_CreateTextureFromSurface(g_renderer, atlas);
+
+    SDL_DestroySurface(atlas);
+
+    if (!r_asciiatlas) {
+        SDL_Log("Failed to create glyph atlas texture: %s", SDL_GetError());
+        return 0;
+    }
+
+    SDL_SetTextureScaleMode(r_asciiatlas, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(r_asciiatlas, SDL_BLENDMODE_BLEND);
+
+    SDL_Log("Loaded glyph atlas: %d chars", numChars);
+
     return 1;
 }
 
-void setTextureColor(u32 textureID, u32 color)
+// solid white placeholder texture, for running without resource files
+bool loadBlankTexture(u16 width, u16 height, u8 textureID)
 {
+    rAssert(width);
+    rAssert(height);
+    rAssert(g_renderer);
     rAssert(textureID < MAX_TEXTURES);
-    rAssert(r_textures[textureID].sdltex);
 
-    SDL_SetTextureColorMod(r_textures[textureID].sdltex, color >> 24, color >> 16, color >> 8);
+    SDL_Surface* surf = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+
+    if (!surf) {
+        SDL_Log("Failed to create blank texture %d: %s", textureID, SDL_GetError());
+        return 0;
+    }
+
+    SDL_FillSurfaceRect(surf, NULL, SDL_MapSurfaceRGBA(surf, 255, 255, 255, 255));
+
+    r_textures[textureID].width = width;
+    r_textures[textureID].height = height;
+    r_textures[textureID].color = COLOR_WHITE;
+    r_textures[textureID].sdltex = SDL_CreateTextureFromSurface(g_renderer, surf);
+
+    SDL_DestroySurface(surf);
+
+    if (!r_textures[textureID].sdltex) {
+        SDL_Log("Failed to create blank texture %d: %s", textureID, SDL_GetError());
+        return 0;
+    }
+
+    SDL_SetTextureScaleMode(r_textures[textureID].sdltex, SDL_SCALEMODE_NEAREST);
+
+    return 1;
 }
 
-// render texture at textureID with scale >= 1
-void renderTexture(i16 xpos, i16 ypos, u16 scale, u16 textureID)
+// placeholder glyph atlas with a solid square per char, same layout as loadCharTextures
+bool loadBlankCharTextures(u32 numChars)
 {
-    rAssert(scale);
     rAssert(g_renderer);
-    rAssert(textureID < MAX_TEXTURES);
-    rAssert(r_textures[textureID].sdltex);
+    rAssert(numChars <= MAX_ASCII_TEXTURES);
 
-    SDL_FRect dst = {
-        (f32) xpos,
-        (f32) ypos,
-        (f32) r_textures[textureID].width * scale,
-        (f32) r_textures[textureID].height * scale
-    };
+    const u32 rows = (numChars + RENDER_ATLAS_COLS - 1) / RENDER_ATLAS_COLS;
+    const u32 atlasw = RENDER_ATLAS_COLS * RENDER_GLYPH_SIZE;
+    const u32 atlash = rows * RENDER_GLYPH_SIZE;
+
+    SDL_Surface* atlas = SDL_CreateSurface(atlasw, atlash, SDL_PIXELFORMAT_RGBA32);
+
+    if (!atlas) {
+        SDL_Log("Failed to create glyph atlas: %s", SDL_GetError());
+        return 0;
+    }
+
+    for (u32 i = 0; i < numChars; i++) {
+        SDL_Rect dst = {
+            (i % RENDER_ATLAS_COLS) * RENDER_GLYPH_SIZE,
+            (i / RENDER_ATLAS_COLS) * RENDER_GLYPH_SIZE,
+            RENDER_GLYPH_SIZE,
+            RENDER_GLYPH_SIZE
+        };
+
+        SDL_FillSurfaceRect(atlas, &dst, SDL_MapSurfaceRGBA(atlas, 255, 255, 255, 255));
+
+        r_asciiuv[i].x = (f32) dst.x / atlasw;
+        r_asciiuv[i].y = (f32) dst.y / atlash;
+        r_asciiuv[i].w = (f32) (dst.x + dst.w) / atlasw;
+        r_asciiuv[i].h = (f32) (dst.y + dst.h) / atlash;
+    }
+
+    r_asciiatlas = SDL_CreateTextureFromSurface(g_renderer, atlas);
 
-    SDL_RenderTexture(g_renderer, r_textures[textureID].sdltex, NULL, &dst);
+    SDL_DestroySurface(atlas);
+
+    if (!r_asciiatlas) {
+        SDL_Log("Failed to create glyph atlas texture: %s", SDL_GetError());
+        return 0;
+    }
+
+    SDL_SetTextureScaleMode(r_asciiatlas, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(r_asciiatlas, SDL_BLENDMODE_BLEND);
+
+    SDL_Log("Created blank glyph atlas: %d chars", numChars);
+
+    return 1;
 }
 
-// render texture with either vertical or horizontal flip
-void renderTextureFlip(i16 xpos, i16 ypos, u8 scale, bool vFlip, bool hFlip, u8 textureID)
+// color mod of texture, applied as vertex color when its quads are drawn
+void setTextureColor(u32 textureID, u32 color)
 {
-    rAssert(scale);
-    rAssert(g_renderer);
     rAssert(textureID < MAX_TEXTURES);
     rAssert(r_textures[textureID].sdltex);
 
-    SDL_FRect dst = {
-        (f32) xpos,
-        (f32) ypos,
-        (f32) r_textures[textureID].width * scale,
-        (f32) r_textures[textureID].height * scale
-    };
+    r_textures[textureID].color = color;
+}
+
+// render texture at textureID with scale >= 1
+void renderTexture(i16 xpos, i16 ypos, u16 scale, u16 textureID)
+{
+    recordTexture(xpos, ypos, scale, 0, SDL_FLIP_NONE, textureID);
+}
 
+// render texture with either vertical or horizontal flip
+void renderTextureFlip(i16 xpos, i16 ypos, u8 scale, bool vFlip, bool hFlip, u8 textureID)
+{
     SDL_FlipMode flip = vFlip ? SDL_FLIP_VERTICAL : (hFlip ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
 
-    SDL_RenderTextureRotated(g_renderer, r_textures[textureID].sdltex, NULL, &dst, 0.0f, NULL, flip);
+    recordTexture(xpos, ypos, scale, 0, flip, textureID);
 }
 
 // render texture with rotation around texture center
 void renderTextureRotate(i16 xpos, i16 ypos, u16 rotation, u8 scale, u8 textureID)
 {
-    rAssert(scale);
-    rAssert(g_renderer);
-    rAssert(textureID < MAX_TEXTURES);
-    rAssert(r_textures[textureID].sdltex);
+    recordTexture(xpos, ypos, scale, rotation, SDL_FLIP_NONE, textureID);
+}
 
-    SDL_FRect dst = {
-        (f32) xpos,
-        (f32) ypos,
-        (f32) r_textures[textureID].width * scale,
-        (f32) r_textures[textureID].height * scale
-    };
+// append char to glyph batch, drawn on next flush
+void renderChar(i16 xpos, i16 ypos, f32 scale, char charID)
+{
+    renderCharColor(xpos, ypos, scale, COLOR_WHITE, charID);
+}
 
-    SDL_RenderTextureRotated(g_renderer, r_textures[textureID].sdltex, NULL, &dst, (f64) rotation, NULL, SDL_FLIP_NONE);
+void renderCharColor(i16 xpos, i16 ypos, f32 scale, u32 color, char charID)
+{
+    const SDL_FRect dst = {(f32) xpos, (f32) ypos, RENDER_GLYPH_SIZE * scale, RENDER_GLYPH_SIZE * scale};
+
+    renderCharRect(&dst, color, charID);
 }
 
-void renderChar(i16 xpos, i16 ypos, f32 scale, char charID)
+// append char with precomputed destination, see asciiPlace2D
+void renderCharRect(const SDL_FRect* dst, u32 color, char charID)
 {
-    rAssert(g_renderer);
+    rAssert(dst);
     rAssert(charID > 31);
     rAssert(charID < 127);
-    rAssert(r_asciitex[charID - 32]);
 
-    SDL_FRect dst = {
-        (f32) xpos,
-        (f32) ypos,
-        (f32) 64 * scale,
-        (f32) 64 * scale
-    };
+    rendercmd_t* cmd = recordCommand(RENDER_CMD_QUAD, r_layer);
 
-    if (!SDL_RenderTexture(g_renderer, r_asciitex[charID - 32], NULL, &dst))
-        SDL_Log("Failed to render char: %s", SDL_GetError());
+    cmd->dst = *dst;
+    cmd->color = color;
+    cmd->texture = RENDER_TEX_ATLAS;
+    cmd->param = (Uint8) (charID - 32);
 }
 
-void renderCharColor(i16 xpos, i16 ypos, f32 scale, u32 color, char charID)
+// draw recorded commands sorted by layer, texture and color, adjacent compatible commands share one SDL call
+void renderFlush(void)
 {
-    rAssert(charID > 31);
-    rAssert(charID < 127);
+    rAssert(g_renderer);
+
+    u64 drawCalls = r_stats.drawCalls;
+    u64 stateChanges = r_stats.stateChanges;
+
+    countImmediate();
+
+    Uint32 color = 0;
+    bool hasColor = 0;
+    i32 bound = -1;     // texture of last draw, -1 for none
+
+    if (r_clear) {
+        setDrawColor(r_clearcolor, &color, &hasColor);
+        SDL_RenderClear(g_renderer);
+
+        r_stats.drawCalls++;
+        r_clear = 0;
+    }
+
+    const Uint64* order = sortCommands();
 
-    // only change color mod if necessary
-    if (r_asciicolors[charID - 32] != color) {
-        SDL_SetTextureColorMod(r_asciitex[charID - 32], color >> 24, color >> 16, color >> 8);
-        r_asciicolors[charID - 32] = color;
+    for (u32 i = 0; i < r_cmdcount;) {
+        const rendercmd_t* cmd = r_cmds + (Uint16) order[i];
+        Uint64 key = order[i] >> 16;
+
+        // run of commands with the same key, fills and outlines include color in the key
+        u32 end = i + 1;
+
+        while (end < r_cmdcount && order[end] >> 16 == key)
+            end++;
+
+        if (cmd->type == RENDER_CMD_QUAD) {
+            i32 texture = cmd->texture;
+
+            if (bound != texture)
+                r_stats.stateChanges++;
+
+            bound = texture;
+
+            drawQuads(order + i, end - i);
+        } else {
+            if (bound != -1)
+                r_stats.stateChanges++;
+
+            bound = -1;
+
+            setDrawColor(cmd->color, &color, &hasColor);
+            drawRects(order + i, end - i, cmd->type);
+        }
+
+        i = end;
     }
 
-    renderChar(xpos, ypos, scale, charID);
+    r_cmdcount = 0;
+
+    // text slots drawn so far are no longer sampled and can be rebaked
+    r_textframe++;
+
+    profCount(PROF_COUNTER_DRAW_CALLS, (u32) (r_stats.drawCalls - drawCalls));
+    profCount(PROF_COUNTER_STATE_CHANGES, (u32) (r_stats.stateChanges - stateChanges));
+}
+
+// flush pending draw calls and present frame
+void presentScreen(void)
+{
+    rAssert(g_renderer);
+
+    profDrawOverlay();
+
+    profBegin(PROF_ZONE_PRESENT);
+
+    renderFlush();
+
+    SDL_RenderPresent(g_renderer);
+
+    r_layer = RENDER_LAYER_HUD;
+    r_stats.frames++;
+
+    profEnd(PROF_ZONE_PRESENT);
+}
+
+void renderGetStats(renderstats_t* stats)
+{
+    rAssert(stats);
+
+    *stats = r_stats;
+}
+
+void renderResetStats(void)
+{
+    memset(&r_stats, 0, sizeof(r_stats));
 }
 
 void renderStr(i16 xpos, i16 ypos, f32 scale, const char* str)
 {
     rAssert(str);
 
-    for (u32 i = 0; i < strnlen(str, RENDER_TXT_MAX_LEN); i++) {
+    const u32 len = strnlen(str, RENDER_TXT_MAX_LEN);
+
+    for (u32 i = 0; i < len; i++) {
         if (str[i] < 33 || str[i] > 125)
             continue;
         
@@ -279,7 +944,9 @@ void renderStrColor(i32 xpos, i32 ypos, f32 scale, u32 color, const char* str)
 {
     rAssert(str);
 
-    for (u32 i = 0; i < strnlen(str, RENDER_TXT_MAX_LEN); i++) {
+    const u32 len = strnlen(str, RENDER_TXT_MAX_LEN);
+
+    for (u32 i = 0; i < len; i++) {
         if (str[i] < 33 || str[i] > 125)
             continue;
 
@@ -293,13 +960,16 @@ void renderStrColorFmt(i32 xpos, i32 ypos, f32 scale, u32 color, const char* fmt
 
     va_start(args, fmt);
 
-    char str[RENDER_TXT_MAX_LEN];
+    // frame scratch, valid until the end of the frame
+    char* str = (char*) memFrameAlloc(RENDER_TXT_MAX_LEN);
 
-    vsnprintf(str, RENDER_TXT_MAX_LEN, fmt, args);
+    if (str) {
+        vsnprintf(str, RENDER_TXT_MAX_LEN, fmt, args);
 
-    str[RENDER_TXT_MAX_LEN - 1] = '\0';
+        str[RENDER_TXT_MAX_LEN - 1] = '\0';
 
-    renderStrColor(xpos, ypos, scale, color, str);
+        renderStrColor(xpos, ypos, scale, color, str);
+    }
 
     va_end(args);
 }
@@ -317,15 +987,136 @@ void renderStrColorFmtCentered(i64 ypos, f32 scale, u32 color, const char* fmt,
 
     va_start(args, fmt);
 
-    char str[RENDER_TXT_MAX_LEN];
+    char* str = (char*) memFrameAlloc(RENDER_TXT_MAX_LEN);
 
-    f32 xpos = scale * 64 * vsnprintf(str, RENDER_TXT_MAX_LEN, fmt, args);
+    if (str) {
+        f32 xpos = scale * 64 * vsnprintf(str, RENDER_TXT_MAX_LEN, fmt, args);
 
-    xpos = (WINDOW_WIDTH / 2) - (xpos / 2);
+        xpos = (WINDOW_WIDTH / 2) - (xpos / 2);
 
-    str[RENDER_TXT_MAX_LEN - 1] = '\0';
+        str[RENDER_TXT_MAX_LEN - 1] = '\0';
 
-    renderStrColor(xpos, ypos, scale, color, str);
+        renderStrColor(xpos, ypos, scale, color, str);
+    }
 
     va_end(args);
+}
+
+// string from the text cache, baked into a slot on first use and drawn as one quad while string, scale and color stay the same
+void renderStrCached(i32 xpos, i32 ypos, f32 scale, u32 color, const char* str)
+{
+    rAssert(str);
+
+    Uint32 hash = 0x811c9dc5;
+    u32 len = 0;
+
+    // length and fnv-1a hash in one pass
+    while (str[len] && len < RENDER_TEXT_CACHE_LEN) {
+        hash = (hash ^ (Uint8) str[len]) * 0x01000193;
+        len++;
+    }
+
+    if (!len)
+        return;
+
+    const f32 width = ceilf(len * RENDER_GLYPH_SIZE * scale);
+    const f32 height = ceilf(RENDER_GLYPH_SIZE * scale);
+
+    textslot_t* slot = findTextSlot(str, len, hash, scale, color);
+
+    if (slot) {
+        r_stats.textHits++;
+        profCount(PROF_COUNTER_TEXT_HITS, 1);
+    } else {
+        r_stats.textMisses++;
+        profCount(PROF_COUNTER_TEXT_MISSES, 1);
+
+        bool fits = len < RENDER_TEXT_CACHE_LEN && width <= RENDER_TEXT_ATLAS_SIZE && height <= RENDER_TEXT_SLOT_HEIGHT;
+
+        // too long or large, no target textures, or every slot was drawn since the last flush
+        if (!fits || !r_asciiatlas || !createTextAtlas() || !(slot = evictTextSlot())) {
+            renderStrColor(xpos, ypos, scale, color, str);
+            return;
+        }
+
+        u32 idx = (u32) (slot - r_textslots);
+
+        if (!bakeText(idx, str, len, scale, color)) {
+            slot->lastUsed = 0;
+            renderStrColor(xpos, ypos, scale, color, str);
+            return;
+        }
+
+        memcpy(slot->text, str, len);
+
+        slot->len = len;
+        slot->hash = hash;
+        slot->scale = scale;
+        slot->color = color;
+
+        // uv rect stored as x0, y0, x1, y1 like the glyph atlas
+        r_textuv[idx].x = 0.0f;
+        r_textuv[idx].y = (f32) (idx * RENDER_TEXT_SLOT_HEIGHT) / RENDER_TEXT_ATLAS_SIZE;
+        r_textuv[idx].w = width / RENDER_TEXT_ATLAS_SIZE;
+        r_textuv[idx].h = (idx * RENDER_TEXT_SLOT_HEIGHT + height) / RENDER_TEXT_ATLAS_SIZE;
+    }
+
+    slot->lastUsed = ++r_textclock;
+    slot->frame = r_textframe;
+
+    rendercmd_t* cmd = recordCommand(RENDER_CMD_QUAD, r_layer);
+
+    cmd->dst = (SDL_FRect) {(f32) xpos, (f32) ypos, width, height};
+    cmd->color = COLOR_WHITE;
+    cmd->texture = RENDER_TEX_TEXT;
+    cmd->param = (Uint8) (slot - r_textslots);
+}
+
+void renderStrCachedCentered(i64 ypos, f32 scale, u32 color, const char* str)
+{
+    f32 xpos = (WINDOW_WIDTH / 2) - ((strnlen(str, RENDER_TXT_MAX_LEN) * 64 * scale) / 2);
+
+    renderStrCached(xpos, ypos, scale, color, str);
+}
+
+// forget all baked strings, e.g. after the renderer lost its target textures
+void renderTextCacheClear(void)
+{
+    memset(r_textslots, 0, sizeof(r_textslots));
+}
+
+// decimal like "%*llu" without going through vsnprintf, two digits per division
+// dst needs room for SDL_max(width, RENDER_U64_MAX_DIGITS) + 1 chars, returns length
+u32 renderFormatU64(char* dst, u64 value, u32 width)
+{
+    char digits[RENDER_U64_MAX_DIGITS];
+    u32 first = RENDER_U64_MAX_DIGITS;
+
+    rAssert(dst);
+
+    while (value >= 100) {
+        const char* pair = r_digitpairs + (value % 100) * 2;
+
+        value /= 100;
+
+        digits[--first] = pair[1];
+        digits[--first] = pair[0];
+    }
+
+    if (value >= 10) {
+        digits[--first] = r_digitpairs[value * 2 + 1];
+        digits[--first] = r_digitpairs[value * 2];
+    } else {
+        digits[--first] = (char) ('0' + value);
+    }
+
+    u32 len = RENDER_U64_MAX_DIGITS - first;
+    u32 pad = width > len ? width - len : 0;
+
+    memset(dst, ' ', pad);
+    memcpy(dst + pad, digits + first, len);
+
+    dst[pad + len] = '\0';
+
+    return pad + len;
 }
\ No newline at end of file
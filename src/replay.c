@@ -0,0 +1,279 @@
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <replay.h>
+#include <debug/rdebug.h>
+
+u32 g_rState = REPLAY_STATE_OFF;
+
+SDL_IOStream* g_rFile = NULL;
+
+// playback, whole log is loaded at start
+u8* g_rData = NULL;
+size_t g_rSize = 0;
+size_t g_rPos = 0;
+
+// next undelivered event in playback
+u32 g_rNextType = REPLAY_EV_NONE;
+u64 g_rNextTick = 0;
+u64 g_rNextArg = 0;
+
+// lowest tick the next event may have, 0 after a RESET since ticks restart with the game
+u64 g_rMinTick = 0;
+
+u64 g_rFastForward = 0;
+
+//
+//  Local functions
+//
+static bool writeVarint(u64 value)
+{
+    u8 buf[10];
+    u32 len = 0;
+
+    do {
+        buf[len] = value & 0x7f;
+        value >>= 7;
+
+        if (value)
+            buf[len] |= 0x80;
+
+        len++;
+    } while (value);
+
+    return SDL_WriteIO(g_rFile, buf, len) == len;
+}
+
+static bool readVarint(u64* value)
+{
+    u64 result = 0;
+
+    for (u32 shift = 0; shift < 64 && g_rPos < g_rSize; shift += 7) {
+        u8 byte = g_rData[g_rPos++];
+
+        result |= (u64) (byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static bool readU64(u64* value)
+{
+    if (g_rPos + 8 > g_rSize)
+        return 0;
+
+    *value = 0;
+
+    for (u32 i = 0; i < 8; i++)
+        *value |= (u64) g_rData[g_rPos++] << (i * 8);
+
+    return 1;
+}
+
+static u32 readU32(void)
+{
+    u32 value = 0;
+
+    for (u32 i = 0; i < 4; i++)
+        value |= (u32) g_rData[g_rPos++] << (i * 8);
+
+    return value;
+}
+
+// decode next event into g_rNext*, END on malformed or truncated log or a tick going backwards
+static void readEvent(void)
+{
+    g_rNextType = REPLAY_EV_END;
+
+    if (g_rPos >= g_rSize)
+        return;
+
+    u32 type = g_rData[g_rPos++];
+    u64 tick, arg = 0;
+
+    if (!readVarint(&tick))
+        return;
+
+    if (type == REPLAY_EV_RESET && !readU64(&arg))
+        return;
+
+    if (type == REPLAY_EV_NONE || type > REPLAY_EV_END)
+        return;
+
+    if (tick < g_rMinTick)
+        return;
+
+    g_rMinTick = type == REPLAY_EV_RESET ? 0 : tick;
+
+    g_rNextType = type;
+    g_rNextTick = tick;
+    g_rNextArg = arg;
+}
+
+//
+//  Public functions
+//
+
+// write all following game events to path
+bool replayStartRecording(const char* path, u32 tickRate, bool godMode)
+{
+    rAssert(path);
+    rAssert(g_rState == REPLAY_STATE_OFF);
+
+    g_rFile = SDL_IOFromFile(path, "wb");
+
+    if (!g_rFile) {
+        SDL_Log("Failed to open replay %s: %s", path, SDL_GetError());
+        return 0;
+    }
+
+    if (!SDL_WriteU32LE(g_rFile, REPLAY_MAGIC) ||
+        !SDL_WriteU32LE(g_rFile, REPLAY_VERSION) ||
+        !SDL_WriteU32LE(g_rFile, tickRate) ||
+        !SDL_WriteU8(g_rFile, godMode))
+    {
+        SDL_Log("Failed to write replay header: %s", SDL_GetError());
+        SDL_CloseIO(g_rFile);
+        g_rFile = NULL;
+        return 0;
+    }
+
+    g_rState = REPLAY_STATE_REC;
+
+    SDL_Log("Recording replay to %s", path);
+
+    return 1;
+}
+
+// load log from path, returns recorded tick rate and initial god mode
+bool replayStartPlayback(const char* path, u32* tickRate, bool* godMode)
+{
+    rAssert(path);
+    rAssert(tickRate);
+    rAssert(godMode);
+    rAssert(g_rState == REPLAY_STATE_OFF);
+
+    g_rData = (u8*) SDL_LoadFile(path, &g_rSize);
+    g_rPos = 0;
+
+    if (!g_rData) {
+        SDL_Log("Failed to load replay %s: %s", path, SDL_GetError());
+        return 0;
+    }
+
+    if (g_rSize < 13 || readU32() != REPLAY_MAGIC || readU32() != REPLAY_VERSION) {
+        SDL_Log("Failed to load replay %s: invalid header", path);
+        SDL_free(g_rData);
+        g_rData = NULL;
+        return 0;
+    }
+
+    *tickRate = readU32();
+    *godMode = g_rData[g_rPos++];
+
+    g_rMinTick = 0;
+
+    if (!*tickRate) {
+        SDL_Log("Failed to load replay %s: invalid tick rate", path);
+        SDL_free(g_rData);
+        g_rData = NULL;
+        return 0;
+    }
+
+    readEvent();
+
+    g_rState = REPLAY_STATE_PLAY;
+
+    SDL_Log("Playing replay %s (%llu bytes, %lu Hz)", path, (u64) g_rSize, *tickRate);
+
+    return 1;
+}
+
+void replayStop(void)
+{
+    if (g_rState == REPLAY_STATE_REC) {
+        SDL_CloseIO(g_rFile);
+        g_rFile = NULL;
+    }
+
+    if (g_rState == REPLAY_STATE_PLAY) {
+        SDL_free(g_rData);
+        g_rData = NULL;
+        g_rSize = 0;
+    }
+
+    g_rState = REPLAY_STATE_OFF;
+    g_rFastForward = 0;
+}
+
+u32 replayState(void)
+{
+    return g_rState;
+}
+
+// append event applying to world tick, no-op unless recording
+void replayRecord(u32 type, u64 tick, u64 arg)
+{
+    if (g_rState != REPLAY_STATE_REC)
+        return;
+
+    rAssert(type > REPLAY_EV_NONE && type < REPLAY_EV_END);
+
+    bool ok = SDL_WriteU8(g_rFile, (u8) type) && writeVarint(tick);
+
+    if (ok && type == REPLAY_EV_RESET)
+        ok = SDL_WriteU64LE(g_rFile, arg);
+
+    if (!ok) {
+        SDL_Log("Failed to write replay, recording stopped: %s", SDL_GetError());
+        SDL_CloseIO(g_rFile);
+        g_rFile = NULL;
+        g_rState = REPLAY_STATE_OFF;
+    }
+}
+
+// return next event if it is due at world tick, call repeatedly until it returns NONE
+u32 replayPoll(u64 tick, u64* arg)
+{
+    if (g_rState != REPLAY_STATE_PLAY)
+        return REPLAY_EV_NONE;
+
+    if (g_rNextType == REPLAY_EV_END)
+        return REPLAY_EV_END;
+
+    // events are written before the tick they apply to runs, one in the past would never come due
+    if (g_rNextTick < tick) {
+        SDL_Log("Replay event for tick %llu found at tick %llu, log does not match this game", g_rNextTick, tick);
+        g_rNextType = REPLAY_EV_END;
+        return REPLAY_EV_END;
+    }
+
+    if (g_rNextTick != tick)
+        return REPLAY_EV_NONE;
+
+    u32 type = g_rNextType;
+
+    if (arg)
+        *arg = g_rNextArg;
+
+    readEvent();
+
+    return type;
+}
+
+// step without rendering or pacing until total tick count reaches tick
+void replaySetFastForward(u64 tick)
+{
+    g_rFastForward = tick;
+}
+
+// ticks left to fast forward, 0 once target is reached
+u64 replayFastForwardLeft(u64 totalTicks)
+{
+    return totalTicks < g_rFastForward ? g_rFastForward - totalTicks : 0;
+}
@@ -0,0 +1,81 @@
+#include <rng.h>
+#include <debug/rdebug.h>
+
+static inline u64 splitmix64(u64* state)
+{
+    u64 z = (*state += 0x9e3779b97f4a7c15ull);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
+
+// expand 64 bit seed into full generator state
+void rngSeed(rng_t* rng, u64 seed)
+{
+    rAssert(rng);
+
+    u64 a = splitmix64(&seed);
+    u64 b = splitmix64(&seed);
+
+    rng->s[0] = (Uint32) a;
+    rng->s[1] = (Uint32) (a >> 32);
+    rng->s[2] = (Uint32) b;
+    rng->s[3] = (Uint32) (b >> 32);
+
+    // all zero state never leaves zero
+    if (!(rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]))
+        rng->s[0] = 1;
+}
+
+// seed count lanes from one seed, each lane gets the seed offset by its index
+void rngLanesSeed(rnglanes_t* lanes, u32 count, u64 seed)
+{
+    rAssert(lanes);
+
+    rng_t tmp;
+
+    for (u32 i = 0; i < count; i++) {
+        rngSeed(&tmp, seed + i * 0xd1b54a32d192ed03ull);
+
+        lanes->s[0][i] = tmp.s[0];
+        lanes->s[1][i] = tmp.s[1];
+        lanes->s[2][i] = tmp.s[2];
+        lanes->s[3][i] = tmp.s[3];
+    }
+}
+
+// draw one value per lane for lanes [first, first + count), dst is indexed by lane
+void rngLanesFillRange(rnglanes_t* lanes, u32 first, u32 count, f32* dst, i32 lbound, i32 ubound)
+{
+    rAssert(lanes);
+    rAssert(dst);
+    rAssert(ubound > lbound);
+
+    Uint32* restrict s0 = lanes->s[0];
+    Uint32* restrict s1 = lanes->s[1];
+    Uint32* restrict s2 = lanes->s[2];
+    Uint32* restrict s3 = lanes->s[3];
+
+    const u64 range = ubound - lbound;
+
+    // independent lanes, no loop carried dependency so the compiler can vectorize this
+    for (u32 i = first; i < first + count; i++) {
+        Uint32 a = s0[i], b = s1[i], c = s2[i], d = s3[i];
+
+        Uint32 result = rngRotl(b * 5, 7) * 9;
+        Uint32 t = b << 9;
+
+        c ^= a;
+        d ^= b;
+        b ^= c;
+        a ^= d;
+        c ^= t;
+        d = rngRotl(d, 11);
+
+        s0[i] = a; s1[i] = b; s2[i] = c; s3[i] = d;
+
+        dst[i] = (f32) (lbound + (i32) (((u64) result * range) >> 32));
+    }
+}
\ No newline at end of file
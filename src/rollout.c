@@ -0,0 +1,340 @@
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include <rollout.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+//
+//  Local types
+//
+typedef struct rollout_s rollout_t;
+
+typedef struct shardresult_s {
+    u64 episodes;
+    u64 scoreTotal;
+    u32 scoreMax;
+    u64 hash;
+} shardresult_t;
+
+// each worker owns a deque of shard indices [head, tail), owner pops from head, thieves take from tail
+typedef struct worker_s {
+    SDL_SpinLock lock;
+    u32 head;
+    u32 tail;
+
+    u32 id;
+    rollout_t* ctx;
+    SDL_Thread* thread;
+
+    // preallocated on the main thread, workers never allocate
+    worldbatch_t* batch;
+    u8* actions;
+
+    u64 busyNS;
+    u32 tasks;
+    u32 steals;
+} worker_t;
+
+struct rollout_s {
+    const rolloutcfg_t* cfg;
+    worker_t* workers;
+    shardresult_t* results;
+    u32 numWorkers;
+    u32 shards;
+    u32 shardSize;
+};
+
+//
+//  Local functions
+//
+static inline u32 hash32(u32 x)
+{
+    x = (x ^ (x >> 16)) * 0x85ebca6bu;
+    x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+
+    return x ^ (x >> 16);
+}
+
+// rng streams are per shard so results don't depend on which thread runs it
+static inline u32 shardSeed(u32 seed, u32 shard)
+{
+    return hash32(seed + hash32(shard + 1));
+}
+
+static inline u64 fnv1a(u64 hash, u32 value)
+{
+    for (u32 i = 0; i < 4; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// games step through worldbatch_t, its kernels redo handleBirdVerticalSpeed, scrollScreen and checkCollision per lane
+// without sprite lists, flappy_bench checks a lane against simStep tick by tick
+static void runShard(rollout_t* ctx, worker_t* worker, u32 shard)
+{
+    const rolloutcfg_t* cfg = ctx->cfg;
+
+    u32 first = shard * ctx->shardSize;
+    u32 count = cfg->games - first < ctx->shardSize ? cfg->games - first : ctx->shardSize;
+
+    worldbatch_t* batch = worker->batch;
+    shardresult_t* res = ctx->results + shard;
+
+    memset(res, 0, sizeof(shardresult_t));
+
+    wbatchRestart(batch, count, shardSeed(cfg->seed, shard));
+
+    for (u32 t = 0; t < cfg->ticks; t++) {
+        cfg->policy(batch, worker->actions, cfg->userdata);
+
+        if (!wbatchStep(batch, worker->actions))
+            continue;
+
+        for (u32 i = 0; i < count; i++) {
+            if (!batch->done[i])
+                continue;
+
+            res->episodes++;
+            res->scoreTotal += batch->score[i];
+
+            if (batch->score[i] > res->scoreMax)
+                res->scoreMax = batch->score[i];
+        }
+    }
+
+    u64 hash = 0xcbf29ce484222325ull;
+    u32 bits;
+
+    for (u32 i = 0; i < count; i++) {
+        memcpy(&bits, batch->birdY + i, sizeof(bits));
+
+        hash = fnv1a(hash, bits);
+        hash = fnv1a(hash, batch->score[i]);
+    }
+
+    res->hash = hash;
+}
+
+// take next shard from own deque
+static bool popShard(worker_t* worker, u32* shard)
+{
+    bool found = 0;
+
+    SDL_LockSpinlock(&worker->lock);
+
+    if (worker->head < worker->tail) {
+        *shard = worker->head++;
+        found = 1;
+    }
+
+    SDL_UnlockSpinlock(&worker->lock);
+
+    return found;
+}
+
+// steal upper half of another worker's deque, keep all but the first stolen shard
+static bool stealShard(worker_t* worker, u32* shard)
+{
+    rollout_t* ctx = worker->ctx;
+
+    for (u32 k = 1; k < ctx->numWorkers; k++) {
+        worker_t* victim = ctx->workers + (worker->id + k) % ctx->numWorkers;
+
+        u32 start = 0;
+        u32 end = 0;
+
+        SDL_LockSpinlock(&victim->lock);
+
+        if (victim->head < victim->tail) {
+            u32 n = (victim->tail - victim->head + 1) / 2;
+
+            end = victim->tail;
+            start = end - n;
+            victim->tail = start;
+        }
+
+        SDL_UnlockSpinlock(&victim->lock);
+
+        if (start == end)
+            continue;
+
+        SDL_LockSpinlock(&worker->lock);
+
+        worker->head = start + 1;
+        worker->tail = end;
+
+        SDL_UnlockSpinlock(&worker->lock);
+
+        worker->steals++;
+        *shard = start;
+
+        return 1;
+    }
+
+    return 0;
+}
+
+// no tasks are created while running, so a worker is done once nothing is left to steal
+static int SDLCALL workerMain(void* data)
+{
+    worker_t* worker = (worker_t*) data;
+
+    u32 shard;
+
+    while (popShard(worker, &shard) || stealShard(worker, &shard)) {
+        u64 start = SDL_GetTicksNS();
+
+        runShard(worker->ctx, worker, shard);
+
+        worker->busyNS += SDL_GetTicksNS() - start;
+        worker->tasks++;
+    }
+
+    return 0;
+}
+
+//
+//  Public functions
+//
+
+// simulate cfg->games games for cfg->ticks each on a thread pool, results are independent of thread count
+bool rolloutRun(const rolloutcfg_t* cfg, rolloutstats_t* stats)
+{
+    rAssert(cfg);
+    rAssert(stats);
+    rAssert(cfg->policy);
+    rAssert(cfg->games);
+    rAssert(cfg->tickRate);
+
+    rollout_t ctx;
+
+    ctx.cfg = cfg;
+    ctx.shardSize = cfg->shardSize ? cfg->shardSize : ROLLOUT_STD_SHARD_SIZE;
+    ctx.shards = (cfg->games + ctx.shardSize - 1) / ctx.shardSize;
+    ctx.numWorkers = cfg->threads ? cfg->threads : (u32) SDL_GetNumLogicalCPUCores();
+
+    if (ctx.numWorkers > ROLLOUT_MAX_THREADS)
+        ctx.numWorkers = ROLLOUT_MAX_THREADS;
+
+    if (ctx.numWorkers > ctx.shards)
+        ctx.numWorkers = ctx.shards;
+
+    if (!ctx.numWorkers)
+        ctx.numWorkers = 1;
+
+    ctx.workers = (worker_t*) memAllocInit(sizeof(worker_t), ctx.numWorkers);
+    ctx.results = (shardresult_t*) memAllocInit(sizeof(shardresult_t), ctx.shards);
+
+    if (!ctx.workers || !ctx.results) {
+        memFree(ctx.workers);
+        memFree(ctx.results);
+        return 0;
+    }
+
+    bool success = 1;
+
+    for (u32 i = 0; i < ctx.numWorkers; i++) {
+        worker_t* worker = ctx.workers + i;
+
+        worker->id = i;
+        worker->ctx = &ctx;
+        worker->head = (u32) ((u64) ctx.shards * i / ctx.numWorkers);
+        worker->tail = (u32) ((u64) ctx.shards * (i + 1) / ctx.numWorkers);
+        worker->batch = wbatchCreate(ctx.shardSize, cfg->tickRate, 0);
+        worker->actions = (u8*) memAllocInit(sizeof(u8), ctx.shardSize);
+
+        if (!worker->batch || !worker->actions)
+            success = 0;
+    }
+
+    u64 start = SDL_GetTicksNS();
+
+    if (success) {
+        // caller thread works as worker 0
+        for (u32 i = 1; i < ctx.numWorkers; i++) {
+            ctx.workers[i].thread = SDL_CreateThread(workerMain, "rollout", ctx.workers + i);
+
+            // shards of workers that failed to start get stolen by the others
+            if (!ctx.workers[i].thread)
+                SDL_Log("Failed to start rollout worker %lu: %s", i, SDL_GetError());
+        }
+
+        (void) workerMain(ctx.workers);
+
+        for (u32 i = 1; i < ctx.numWorkers; i++) {
+            if (ctx.workers[i].thread)
+                SDL_WaitThread(ctx.workers[i].thread, NULL);
+        }
+    }
+
+    u64 elapsed = SDL_GetTicksNS() - start;
+
+    memset(stats, 0, sizeof(rolloutstats_t));
+
+    stats->threads = ctx.numWorkers;
+    stats->shards = ctx.shards;
+    stats->elapsedNS = elapsed;
+    stats->envSteps = success ? (u64) cfg->games * cfg->ticks : 0;
+    stats->stepsPerSec = elapsed ? (f64) stats->envSteps * SDL_NS_PER_SECOND / elapsed : 0.0;
+    stats->checksum = 0xcbf29ce484222325ull;
+
+    // merge in shard order
+    for (u32 i = 0; i < ctx.shards && success; i++) {
+        stats->episodes += ctx.results[i].episodes;
+        stats->scoreTotal += ctx.results[i].scoreTotal;
+
+        if (ctx.results[i].scoreMax > stats->scoreMax)
+            stats->scoreMax = ctx.results[i].scoreMax;
+
+        stats->checksum = fnv1a(stats->checksum, (u32) ctx.results[i].hash);
+        stats->checksum = fnv1a(stats->checksum, (u32) (ctx.results[i].hash >> 32));
+    }
+
+    for (u32 i = 0; i < ctx.numWorkers; i++) {
+        stats->workerBusyNS[i] = ctx.workers[i].busyNS;
+        stats->workerTasks[i] = ctx.workers[i].tasks;
+        stats->workerSteals[i] = ctx.workers[i].steals;
+
+        wbatchDestroy(ctx.workers[i].batch);
+        memFree(ctx.workers[i].actions);
+    }
+
+    memFree(ctx.workers);
+    memFree(ctx.results);
+
+    return success;
+}
+
+void rolloutLogStats(const rolloutstats_t* stats)
+{
+    rAssert(stats);
+
+    SDL_Log
+    (
+        "Rollout: %lu threads, %lu shards, %llu env steps in %.3f s, %.0f env steps/s, %llu episodes, avg score %.1f, max score %lu, checksum %016llx",
+        stats->threads,
+        stats->shards,
+        stats->envSteps,
+        (f64) stats->elapsedNS / SDL_NS_PER_SECOND,
+        stats->stepsPerSec,
+        stats->episodes,
+        stats->episodes ? (f64) stats->scoreTotal / stats->episodes : 0.0,
+        stats->scoreMax,
+        stats->checksum
+    );
+
+    for (u32 i = 0; i < stats->threads; i++) {
+        SDL_Log
+        (
+            "  worker %2lu: %4lu tasks, %3lu steals, utilization %5.1f%%",
+            i,
+            stats->workerTasks[i],
+            stats->workerSteals[i],
+            stats->elapsedNS ? 100.0 * stats->workerBusyNS[i] / stats->elapsedNS : 0.0
+        );
+    }
+}
\ No newline at end of file
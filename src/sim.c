@@ -0,0 +1,106 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <sim.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+struct sim_s {
+    world_t world;
+    f32 dt;
+    bool done;
+};
+
+// create headless simulation, no window or renderer required
+sim_t* simCreate(u32 tickRate, u64 seed)
+{
+    rAssert(tickRate);
+
+    sim_t* sim = (sim_t*) memAlloc(sizeof(sim_t));
+
+    if (!sim)
+        return NULL;
+
+    sim->dt = 1.0f / tickRate;
+
+    simSeed(sim, seed);
+
+    return sim;
+}
+
+// reseed and restart, same seed and actions give the same game
+void simSeed(sim_t* sim, u64 seed)
+{
+    rAssert(sim);
+
+    seedWorld(&sim->world, seed);
+
+    simReset(sim);
+}
+
+void simDestroy(sim_t* sim)
+{
+    memFree(sim);
+}
+
+// restart, pipes continue the rng stream so each episode differs
+void simReset(sim_t* sim)
+{
+    rAssert(sim);
+
+    resetWorld(&sim->world);
+
+    sim->done = 0;
+}
+
+// advance one physics tick, returns 1 once the bird has crashed
+bool simStep(sim_t* sim, u32 action)
+{
+    rAssert(sim);
+
+    if (sim->done)
+        return 1;
+
+    sim->world.updraft = action == SIM_ACTION_FLAP;
+
+    if (stepWorld(&sim->world, sim->dt) != GAME_CONTINUE)
+        sim->done = 1;
+
+    return sim->done;
+}
+
+void simObserve(const sim_t* sim, simobs_t* obs)
+{
+    rAssert(sim);
+    rAssert(obs);
+
+    const world_t* world = &sim->world;
+    const sprite_t* bird = world->sprites;
+
+    rAssert(bird->spriteType == SPRITE_BIRD);
+
+    obs->birdY = bird->ypos;
+    obs->birdSpeed = world->birdSpeed;
+    obs->score = world->score;
+    obs->ticks = world->ticks;
+    obs->done = sim->done;
+
+    // next pair is the closest one whose right edge is not yet behind the bird
+    const pipepair_t* next = NULL;
+
+    for (u8 i = 0; i < world->pipesIdx; i++) {
+        const pipepair_t* pair = world->pipes + i;
+
+        if (pair->top->xpos + pair->top->width < bird->xpos)
+            continue;
+
+        if (!next || pair->top->xpos < next->top->xpos)
+            next = pair;
+    }
+
+    rAssert(next);
+
+    obs->pipeDX = next->top->xpos - bird->xpos;
+    obs->gapTop = next->top->ypos + next->top->height;
+    obs->gapBot = next->bot->ypos;
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include <SDL3/SDL.h>
+
+#include <sim.h>
+#include <worldbatch.h>
+#include <rollout.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+#define SIM_DEFAULT_STEPS   10000000
+
+// simple scripted agent, flap when falling below the middle of the next gap
+static u32 policy(const simobs_t* obs)
+{
+    f32 center = (obs->gapTop + obs->gapBot) / 2;
+
+    return (obs->birdY + 24.0f > center + 20.0f && obs->birdSpeed > 0.0f) ? SIM_ACTION_FLAP : SIM_ACTION_NONE;
+}
+
+// same policy for every env of a batch
+static void batchPolicy(const worldbatch_t* batch, u8* actions, void* userdata)
+{
+    for (u32 i = 0; i < batch->count; i++) {
+        f32 nextX = 1e9f;
+        f32 center = 0.0f;
+
+        for (u32 p = 0; p < WBATCH_PIPES; p++) {
+            f32 x = batch->pipeX[p][i];
+
+            if (x + WORLD_STD_PIPE_WIDTH >= WORLD_STD_BIRD_XPOS && x < nextX) {
+                nextX = x;
+                center = (batch->gapTop[p][i] + batch->gapBot[p][i]) / 2;
+            }
+        }
+
+        actions[i] = batch->birdY[i] + 24.0f > center + 20.0f && batch->birdSpeed[i] > 0.0f;
+    }
+}
+
+// run envs games in lockstep, steps counts env steps
+static int runBatch(u64 steps, u32 seed, u32 tickRate, u32 envs)
+{
+    worldbatch_t* batch = wbatchCreate(envs, tickRate, seed);
+    u8* actions = (u8*) memAllocInit(sizeof(u8), envs);
+
+    if (!batch || !actions) {
+        SDL_Log("Failed to create simulation batch");
+        return 1;
+    }
+
+    u64 ticks = (steps + envs - 1) / envs;
+    u64 episodes = 0;
+    u64 policyNS = 0;
+
+    u64 start = SDL_GetTicksNS();
+
+    for (u64 t = 0; t < ticks; t++) {
+        u64 p = SDL_GetTicksNS();
+
+        batchPolicy(batch, actions, NULL);
+
+        policyNS += SDL_GetTicksNS() - p;
+
+        episodes += wbatchStep(batch, actions);
+    }
+
+    u64 elapsed = SDL_GetTicksNS() - start;
+    u64 stepNS = elapsed - policyNS;
+
+    SDL_Log
+    (
+        "Sim batch (%s, %lu envs): %llu env steps in %.3f s, %.0f env steps/s (%.0f excluding policy), %llu episodes",
+        wbatchKernelName(),
+        envs,
+        ticks * envs,
+        (f64) elapsed / SDL_NS_PER_SECOND,
+        elapsed ? (f64) ticks * envs * SDL_NS_PER_SECOND / elapsed : 0.0,
+        stepNS ? (f64) ticks * envs * SDL_NS_PER_SECOND / stepNS : 0.0,
+        episodes
+    );
+
+    memFree(actions);
+    wbatchDestroy(batch);
+
+    return 0;
+}
+
+// spread envs games over a thread pool
+static int runRollout(u64 steps, u32 seed, u32 tickRate, u32 envs, u32 threads)
+{
+    rolloutcfg_t cfg;
+    rolloutstats_t stats;
+
+    cfg.games = envs;
+    cfg.ticks = (u32) ((steps + envs - 1) / envs);
+    cfg.shardSize = 0;
+    cfg.threads = threads;
+    cfg.tickRate = tickRate;
+    cfg.seed = seed;
+    cfg.policy = batchPolicy;
+    cfg.userdata = NULL;
+
+    if (!rolloutRun(&cfg, &stats)) {
+        SDL_Log("Rollout failed");
+        return 1;
+    }
+
+    rolloutLogStats(&stats);
+
+    return 0;
+}
+
+//
+//  Headless simulation, runs as fast as possible and reports throughput
+//
+//  usage: flappy_sim [steps] [seed] [tickrate] [envs] [threads]
+//
+//  threads 0 uses all logical cores
+//
+int main(int argc, char** argv)
+{
+    u64 steps = argc > 1 ? strtoull(argv[1], NULL, 10) : SIM_DEFAULT_STEPS;
+    u32 seed = argc > 2 ? strtoul(argv[2], NULL, 10) : 1;
+    u32 tickRate = argc > 3 ? strtoul(argv[3], NULL, 10) : WORLD_STD_TICK_RATE;
+    u32 envs = argc > 4 ? strtoul(argv[4], NULL, 10) : 1;
+    u32 threads = argc > 5 ? strtoul(argv[5], NULL, 10) : 1;
+
+    if (!steps || !tickRate || !envs) {
+        SDL_Log("usage: flappy_sim [steps] [seed] [tickrate] [envs] [threads]");
+        return 1;
+    }
+
+    if (threads != 1)
+        return runRollout(steps, seed, tickRate, envs, threads);
+
+    if (envs > 1)
+        return runBatch(steps, seed, tickRate, envs);
+
+    sim_t* sim = simCreate(tickRate, seed);
+
+    if (!sim) {
+        SDL_Log("Failed to create simulation");
+        return 1;
+    }
+
+    simobs_t obs;
+    u64 episodes = 0;
+    u64 scoreTotal = 0;
+    u32 scoreMax = 0;
+
+    simObserve(sim, &obs);
+
+    u64 start = SDL_GetTicksNS();
+
+    for (u64 i = 0; i < steps; i++) {
+        if (simStep(sim, policy(&obs))) {
+            simObserve(sim, &obs);
+
+            episodes++;
+            scoreTotal += obs.score;
+
+            if (obs.score > scoreMax)
+                scoreMax = obs.score;
+
+            simReset(sim);
+        }
+
+        simObserve(sim, &obs);
+    }
+
+    u64 elapsed = SDL_GetTicksNS() - start;
+
+    simDestroy(sim);
+
+    SDL_Log
+    (
+        "Sim: %llu steps in %.3f s, %.0f steps/s, %llu episodes, avg score %.1f, max score %lu",
+        steps,
+        (f64) elapsed / SDL_NS_PER_SECOND,
+        elapsed ? (f64) steps * SDL_NS_PER_SECOND / elapsed : 0.0,
+        episodes,
+        episodes ? (f64) scoreTotal / episodes : 0.0,
+        scoreMax
+    );
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,454 @@
+#include <string.h>
+
+#if defined __AVX2__
+    #include <immintrin.h>
+#elif defined __SSE2__
+    #include <emmintrin.h>
+#endif
+
+#include <worldbatch.h>
+#include <debug/rdebug.h>
+#include <debug/memtrack.h>
+
+// fixed sprite geometry from resetWorld / addPipePair
+#define WB_BIRD_W       64.0f
+#define WB_BIRD_H       48.0f
+#define WB_PIPE_W       ((f32) WORLD_STD_PIPE_WIDTH)
+#define WB_PIPE_H       500.0f
+#define WB_WRAP_X       (-210.0f)
+#define WB_RESPAWN_X    (WINDOW_WIDTH + 1.0f)
+#define WB_SPEEDUP_T    (WORLD_STD_SPEEDUP_INTERVAL / 1000.0f)
+
+// same distribution and draw order as randomizePair
+static inline void randomizeGap(worldbatch_t* batch, u32 idx, u32 pipe)
+{
+    f32 gap = rngLaneRange(&batch->rng, idx, 180, 280);
+    f32 bot = rngLaneRange(&batch->rng, idx, WINDOW_HEIGHT / 2, WINDOW_HEIGHT - 70);
+
+    batch->gapBot[pipe][idx] = bot;
+    batch->gapTop[pipe][idx] = bot - gap;
+}
+
+// create batch of count envs, each env gets its own rng stream derived from seed
+worldbatch_t* wbatchCreate(u32 count, u32 tickRate, u64 seed)
+{
+    rAssert(count);
+    rAssert(tickRate);
+
+    worldbatch_t* batch = (worldbatch_t*) memAllocInit(sizeof(worldbatch_t), 1);
+
+    if (!batch)
+        return NULL;
+
+    u32 capacity = (count + WBATCH_LANES - 1) & ~(WBATCH_LANES - 1);
+
+    // 4 f32 + 3 f32 per pipe + 2 u32 + 4 rng state arrays, one allocation
+    u32 arrays = 4 + 3 * WBATCH_PIPES + 2 + 4;
+
+    batch->mem = memAllocInit(capacity * sizeof(f32), arrays);
+
+    if (!batch->mem) {
+        memFree(batch);
+        return NULL;
+    }
+
+    f32* ptr = (f32*) batch->mem;
+
+    batch->birdY = ptr;         ptr += capacity;
+    batch->birdSpeed = ptr;     ptr += capacity;
+    batch->scrollSpeed = ptr;   ptr += capacity;
+    batch->speedupTimer = ptr;  ptr += capacity;
+
+    for (u32 p = 0; p < WBATCH_PIPES; p++) {
+        batch->pipeX[p] = ptr;  ptr += capacity;
+        batch->gapTop[p] = ptr; ptr += capacity;
+        batch->gapBot[p] = ptr; ptr += capacity;
+    }
+
+    batch->score = (Uint32*) ptr;   ptr += capacity;
+    batch->done = (Uint32*) ptr;    ptr += capacity;
+
+    for (u32 k = 0; k < 4; k++) {
+        batch->rng.s[k] = (Uint32*) ptr;
+        ptr += capacity;
+    }
+
+    batch->capacity = capacity;
+    batch->dt = 1.0f / tickRate;
+
+    wbatchRestart(batch, count, seed);
+
+    return batch;
+}
+
+// reuse batch for count <= capacity new games with fresh rng streams
+void wbatchRestart(worldbatch_t* batch, u32 count, u64 seed)
+{
+    rAssert(batch);
+    rAssert(count && count <= batch->capacity);
+
+    batch->count = count;
+
+    rngLanesSeed(&batch->rng, count, seed);
+
+    wbatchReset(batch);
+}
+
+void wbatchDestroy(worldbatch_t* batch)
+{
+    if (!batch)
+        return;
+
+    memFree(batch->mem);
+    memFree(batch);
+}
+
+// reset all envs, pipe gaps for all envs are drawn in one pass per pipe and value
+void wbatchReset(worldbatch_t* batch)
+{
+    rAssert(batch);
+
+    const u32 n = batch->count;
+
+    for (u32 i = 0; i < n; i++) {
+        batch->birdY[i] = WORLD_STD_BIRD_YPOS;
+        batch->birdSpeed[i] = 0.0f;
+        batch->scrollSpeed[i] = WORLD_STD_SCROLL_V;
+        batch->speedupTimer[i] = 0.0f;
+        batch->score[i] = 100;
+        batch->done[i] = 0;
+    }
+
+    for (u32 p = 0; p < WBATCH_PIPES; p++) {
+        f32* top = batch->gapTop[p];
+        f32* bot = batch->gapBot[p];
+
+        rngLanesFillRange(&batch->rng, 0, n, top, 180, 280);
+        rngLanesFillRange(&batch->rng, 0, n, bot, WINDOW_HEIGHT / 2, WINDOW_HEIGHT - 70);
+
+        for (u32 i = 0; i < n; i++) {
+            batch->pipeX[p][i] = WORLD_STD_FIRST_PIPE_D + p * WORLD_STD_PIPE_DISTANCE;
+            top[i] = bot[i] - top[i];
+        }
+    }
+
+    batch->steps = 0;
+}
+
+// reset single env to start of game
+void wbatchResetEnv(worldbatch_t* batch, u32 idx)
+{
+    rAssert(batch);
+    rAssert(idx < batch->count);
+
+    batch->birdY[idx] = WORLD_STD_BIRD_YPOS;
+    batch->birdSpeed[idx] = 0.0f;
+    batch->scrollSpeed[idx] = WORLD_STD_SCROLL_V;
+    batch->speedupTimer[idx] = 0.0f;
+    batch->score[idx] = 100;
+    batch->done[idx] = 0;
+
+    for (u32 p = 0; p < WBATCH_PIPES; p++) {
+        batch->pipeX[p][idx] = WORLD_STD_FIRST_PIPE_D + p * WORLD_STD_PIPE_DISTANCE;
+        randomizeGap(batch, idx, p);
+    }
+}
+
+// step one env, also used for the tail that doesn't fill a vector
+static u32 stepScalar(worldbatch_t* batch, u32 i, u8 action)
+{
+    const f32 dt = batch->dt;
+    const f32 dx = batch->scrollSpeed[i] * dt;
+
+    f32 v = batch->birdSpeed[i];
+    u32 hit = 0;
+
+    if (action)
+        v = WORLD_STD_UPDRAFT_V;
+    else if (v < 0.0f)
+        v += 3 * WORLD_STD_GRAVITY_DV * dt;
+    else
+        v += WORLD_STD_GRAVITY_DV * dt;
+
+    f32 y = batch->birdY[i] + v * dt;
+
+    batch->birdSpeed[i] = v;
+    batch->birdY[i] = y;
+
+    if ((batch->speedupTimer[i] += dt) >= WB_SPEEDUP_T) {
+        batch->scrollSpeed[i] -= 5.0f;
+        batch->score[i] += 100;
+        batch->speedupTimer[i] -= WB_SPEEDUP_T;
+    }
+
+    for (u32 p = 0; p < WBATCH_PIPES; p++) {
+        if (batch->pipeX[p][i] < WB_WRAP_X) {
+            batch->pipeX[p][i] = WB_RESPAWN_X;
+            randomizeGap(batch, i, p);
+        }
+
+        f32 x = batch->pipeX[p][i] += dx;
+
+        if (x > WORLD_STD_BIRD_XPOS + WB_BIRD_W || x + WB_PIPE_W < WORLD_STD_BIRD_XPOS)
+            continue;
+
+        f32 top = batch->gapTop[p][i];
+        f32 bot = batch->gapBot[p][i];
+
+        if (!(top < y || top - WB_PIPE_H > y + WB_BIRD_H))
+            hit = 1;
+
+        if (!(bot + WB_PIPE_H < y || bot > y + WB_BIRD_H))
+            hit = 1;
+    }
+
+    batch->done[i] = hit;
+
+    return hit;
+}
+
+#if defined __AVX2__
+
+#define WB_KERNEL_NAME  "avx2"
+#define WB_WIDTH        8
+
+// step 8 envs at once
+static u32 stepBlock(worldbatch_t* batch, u32 i, const u8* actions)
+{
+    const __m256 dt = _mm256_set1_ps(batch->dt);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256i act = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) (actions + i)));
+    __m256 flap = _mm256_castsi256_ps(_mm256_cmpgt_epi32(act, _mm256_setzero_si256()));
+
+    // gravity integration, falls 3 times faster while still rising
+    __m256 v = _mm256_loadu_ps(batch->birdSpeed + i);
+    __m256 rising = _mm256_cmp_ps(v, zero, _CMP_LT_OQ);
+    __m256 g = _mm256_blendv_ps(_mm256_set1_ps(WORLD_STD_GRAVITY_DV), _mm256_set1_ps(3 * WORLD_STD_GRAVITY_DV), rising);
+
+    v = _mm256_add_ps(v, _mm256_mul_ps(g, dt));
+    v = _mm256_blendv_ps(v, _mm256_set1_ps(WORLD_STD_UPDRAFT_V), flap);
+
+    __m256 y = _mm256_add_ps(_mm256_loadu_ps(batch->birdY + i), _mm256_mul_ps(v, dt));
+
+    _mm256_storeu_ps(batch->birdSpeed + i, v);
+    _mm256_storeu_ps(batch->birdY + i, y);
+
+    // speedup
+    __m256 scroll = _mm256_loadu_ps(batch->scrollSpeed + i);
+    __m256 timer = _mm256_add_ps(_mm256_loadu_ps(batch->speedupTimer + i), dt);
+    __m256 speedup = _mm256_cmp_ps(timer, _mm256_set1_ps(WB_SPEEDUP_T), _CMP_GE_OQ);
+
+    __m256 dx = _mm256_mul_ps(scroll, dt);
+
+    scroll = _mm256_sub_ps(scroll, _mm256_and_ps(speedup, _mm256_set1_ps(5.0f)));
+    timer = _mm256_sub_ps(timer, _mm256_and_ps(speedup, _mm256_set1_ps(WB_SPEEDUP_T)));
+
+    __m256i score = _mm256_loadu_si256((const __m256i*) (batch->score + i));
+    score = _mm256_add_epi32(score, _mm256_and_si256(_mm256_castps_si256(speedup), _mm256_set1_epi32(100)));
+
+    _mm256_storeu_ps(batch->scrollSpeed + i, scroll);
+    _mm256_storeu_ps(batch->speedupTimer + i, timer);
+    _mm256_storeu_si256((__m256i*) (batch->score + i), score);
+
+    // scroll pipes and check collision
+    const __m256 ybot = _mm256_add_ps(y, _mm256_set1_ps(WB_BIRD_H));
+    __m256 hit = zero;
+
+    for (u32 p = 0; p < WBATCH_PIPES; p++) {
+        __m256 x = _mm256_loadu_ps(batch->pipeX[p] + i);
+        u32 wrap = _mm256_movemask_ps(_mm256_cmp_ps(x, _mm256_set1_ps(WB_WRAP_X), _CMP_LT_OQ));
+
+        // respawn is rare, handle it per lane
+        if (wrap) {
+            for (u32 k = 0; k < WB_WIDTH; k++) {
+                if (wrap & (1 << k)) {
+                    batch->pipeX[p][i + k] = WB_RESPAWN_X;
+                    randomizeGap(batch, i + k, p);
+                }
+            }
+
+            x = _mm256_loadu_ps(batch->pipeX[p] + i);
+        }
+
+        x = _mm256_add_ps(x, dx);
+
+        _mm256_storeu_ps(batch->pipeX[p] + i, x);
+
+        __m256 top = _mm256_loadu_ps(batch->gapTop[p] + i);
+        __m256 bot = _mm256_loadu_ps(batch->gapBot[p] + i);
+
+        __m256 hx = _mm256_and_ps(
+            _mm256_cmp_ps(x, _mm256_set1_ps(WORLD_STD_BIRD_XPOS + WB_BIRD_W), _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_add_ps(x, _mm256_set1_ps(WB_PIPE_W)), _mm256_set1_ps(WORLD_STD_BIRD_XPOS), _CMP_GE_OQ)
+        );
+
+        __m256 ht = _mm256_and_ps(
+            _mm256_cmp_ps(top, y, _CMP_GE_OQ),
+            _mm256_cmp_ps(_mm256_sub_ps(top, _mm256_set1_ps(WB_PIPE_H)), ybot, _CMP_LE_OQ)
+        );
+
+        __m256 hb = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_add_ps(bot, _mm256_set1_ps(WB_PIPE_H)), y, _CMP_GE_OQ),
+            _mm256_cmp_ps(bot, ybot, _CMP_LE_OQ)
+        );
+
+        hit = _mm256_or_ps(hit, _mm256_and_ps(hx, _mm256_or_ps(ht, hb)));
+    }
+
+    __m256i done = _mm256_srli_epi32(_mm256_castps_si256(hit), 31);
+
+    _mm256_storeu_si256((__m256i*) (batch->done + i), done);
+
+    return __builtin_popcount(_mm256_movemask_ps(hit));
+}
+
+#elif defined __SSE2__
+
+#define WB_KERNEL_NAME  "sse2"
+#define WB_WIDTH        4
+
+static inline __m128 blendps(__m128 a, __m128 b, __m128 mask)
+{
+    return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+// step 4 envs at once
+static u32 stepBlock(worldbatch_t* batch, u32 i, const u8* actions)
+{
+    const __m128 dt = _mm_set1_ps(batch->dt);
+    const __m128 zero = _mm_setzero_ps();
+
+    // 4 actions, i32 would read 8 on LP64 targets
+    Sint32 packed;
+    memcpy(&packed, actions + i, sizeof(packed));
+
+    __m128i act = _mm_cvtsi32_si128(packed);
+    act = _mm_unpacklo_epi8(act, _mm_setzero_si128());
+    act = _mm_unpacklo_epi16(act, _mm_setzero_si128());
+
+    __m128 flap = _mm_castsi128_ps(_mm_cmpgt_epi32(act, _mm_setzero_si128()));
+
+    // gravity integration, falls 3 times faster while still rising
+    __m128 v = _mm_loadu_ps(batch->birdSpeed + i);
+    __m128 rising = _mm_cmplt_ps(v, zero);
+    __m128 g = blendps(_mm_set1_ps(WORLD_STD_GRAVITY_DV), _mm_set1_ps(3 * WORLD_STD_GRAVITY_DV), rising);
+
+    v = _mm_add_ps(v, _mm_mul_ps(g, dt));
+    v = blendps(v, _mm_set1_ps(WORLD_STD_UPDRAFT_V), flap);
+
+    __m128 y = _mm_add_ps(_mm_loadu_ps(batch->birdY + i), _mm_mul_ps(v, dt));
+
+    _mm_storeu_ps(batch->birdSpeed + i, v);
+    _mm_storeu_ps(batch->birdY + i, y);
+
+    // speedup
+    __m128 scroll = _mm_loadu_ps(batch->scrollSpeed + i);
+    __m128 timer = _mm_add_ps(_mm_loadu_ps(batch->speedupTimer + i), dt);
+    __m128 speedup = _mm_cmpge_ps(timer, _mm_set1_ps(WB_SPEEDUP_T));
+
+    __m128 dx = _mm_mul_ps(scroll, dt);
+
+    scroll = _mm_sub_ps(scroll, _mm_and_ps(speedup, _mm_set1_ps(5.0f)));
+    timer = _mm_sub_ps(timer, _mm_and_ps(speedup, _mm_set1_ps(WB_SPEEDUP_T)));
+
+    __m128i score = _mm_loadu_si128((const __m128i*) (batch->score + i));
+    score = _mm_add_epi32(score, _mm_and_si128(_mm_castps_si128(speedup), _mm_set1_epi32(100)));
+
+    _mm_storeu_ps(batch->scrollSpeed + i, scroll);
+    _mm_storeu_ps(batch->speedupTimer + i, timer);
+    _mm_storeu_si128((__m128i*) (batch->score + i), score);
+
+    // scroll pipes and check collision
+    const __m128 ybot = _mm_add_ps(y, _mm_set1_ps(WB_BIRD_H));
+    __m128 hit = zero;
+
+    for (u32 p = 0; p < WBATCH_PIPES; p++) {
+        __m128 x = _mm_loadu_ps(batch->pipeX[p] + i);
+        u32 wrap = _mm_movemask_ps(_mm_cmplt_ps(x, _mm_set1_ps(WB_WRAP_X)));
+
+        // respawn is rare, handle it per lane
+        if (wrap) {
+            for (u32 k = 0; k < WB_WIDTH; k++) {
+                if (wrap & (1 << k)) {
+                    batch->pipeX[p][i + k] = WB_RESPAWN_X;
+                    randomizeGap(batch, i + k, p);
+                }
+            }
+
+            x = _mm_loadu_ps(batch->pipeX[p] + i);
+        }
+
+        x = _mm_add_ps(x, dx);
+
+        _mm_storeu_ps(batch->pipeX[p] + i, x);
+
+        __m128 top = _mm_loadu_ps(batch->gapTop[p] + i);
+        __m128 bot = _mm_loadu_ps(batch->gapBot[p] + i);
+
+        __m128 hx = _mm_and_ps(
+            _mm_cmple_ps(x, _mm_set1_ps(WORLD_STD_BIRD_XPOS + WB_BIRD_W)),
+            _mm_cmpge_ps(_mm_add_ps(x, _mm_set1_ps(WB_PIPE_W)), _mm_set1_ps(WORLD_STD_BIRD_XPOS))
+        );
+
+        __m128 ht = _mm_and_ps(
+            _mm_cmpge_ps(top, y),
+            _mm_cmple_ps(_mm_sub_ps(top, _mm_set1_ps(WB_PIPE_H)), ybot)
+        );
+
+        __m128 hb = _mm_and_ps(
+            _mm_cmpge_ps(_mm_add_ps(bot, _mm_set1_ps(WB_PIPE_H)), y),
+            _mm_cmple_ps(bot, ybot)
+        );
+
+        hit = _mm_or_ps(hit, _mm_and_ps(hx, _mm_or_ps(ht, hb)));
+    }
+
+    __m128i done = _mm_srli_epi32(_mm_castps_si128(hit), 31);
+
+    _mm_storeu_si128((__m128i*) (batch->done + i), done);
+
+    return __builtin_popcount(_mm_movemask_ps(hit));
+}
+
+#else
+
+#define WB_KERNEL_NAME  "scalar"
+#define WB_WIDTH        1
+
+static u32 stepBlock(worldbatch_t* batch, u32 i, const u8* actions)
+{
+    return stepScalar(batch, i, actions[i]);
+}
+
+#endif
+
+// step all envs one tick, envs that crashed last step are reset first, returns number of crashes
+u32 wbatchStep(worldbatch_t* batch, const u8* actions)
+{
+    rAssert(batch);
+    rAssert(actions);
+
+    u32 crashed = 0;
+    u32 i = 0;
+
+    for (u32 k = 0; k < batch->count; k++) {
+        if (batch->done[k])
+            wbatchResetEnv(batch, k);
+    }
+
+    for (; i + WB_WIDTH <= batch->count; i += WB_WIDTH)
+        crashed += stepBlock(batch, i, actions);
+
+    for (; i < batch->count; i++)
+        crashed += stepScalar(batch, i, actions[i]);
+
+    batch->steps++;
+
+    return crashed;
+}
+
+const char* wbatchKernelName(void)
+{
+    return WB_KERNEL_NAME;
+}
\ No newline at end of file
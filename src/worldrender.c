@@ -0,0 +1,776 @@
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include <worldrender.h>
+#include <objects.h>
+#include <render.h>
+#include <ascii.h>
+#include <replay.h>
+#include <profiler.h>
+#include <debug/rdebug.h>
+
+#define PIPE_MESH_SLOTS         8       // cached ascii pipe columns, 3 pairs on screen use 6
+#define PIPE_MESH_MAX_SECTIONS  48      // pipe heights from randomizePair need up to 27
+
+#define SIM_INPUT_UPDRAFT       0x1
+#define SIM_INPUT_GODMODE       0x2     // flipped per press, two presses between ticks cancel out
+
+//
+//  Local types
+//
+
+// pipe head and its sections composed into one object, one per section count and orientation
+typedef struct pipemesh_s {
+    asciiobj_t* object;
+    i32 sections;
+    bool hanging;       // top pipe, head at the lower end
+    u64 lastUsed;       // renderPipes call that last drew it
+} pipemesh_t;
+
+// game world, owned by the simulation thread while it runs, rendered from snapshots
+world_t g_world;
+
+// fixed timestep state
+u32 g_wTickRate = WORLD_STD_TICK_RATE;
+u64 g_wTickNS = SDL_NS_PER_SECOND / WORLD_STD_TICK_RATE;
+u64 g_wAccumulator = 0;
+u64 g_wTotalTicks = 0;
+
+// simulation side
+u32 g_wResult = GAME_CONTINUE;
+u64 g_wResets = 0;
+u64 g_wUpdrafts = 0;
+u32 g_wResetsTaken = 0;
+u64 g_wPublished = 0;
+
+bool g_wGodMode = 0;
+
+SDL_Thread* g_wSimThread = NULL;
+SDL_AtomicInt g_wSimQuit;
+
+// handed from event handling to simulation
+SDL_AtomicInt g_wInputs;            // SIM_INPUT_*, taken before each step
+SDL_AtomicInt g_wResetRequest;      // count of requested resets
+
+snapbuf_t g_wSnapshots = {.back = 1, .front = 2};
+
+// render side, thread that owns the renderer only
+u32 g_wResetsPosted = 0;
+u64 g_wSeenResets = 0;
+u64 g_wSeenUpdrafts = 0;
+
+bool g_wShowHitboxes = 0;
+
+bool g_wAsciiMode = 0;
+bool g_wUpdraftAnim = 0;
+
+u32 g_wTextColor = COLOR_BLACK;
+u32 g_wBackgroundColor = COLOR_AZURE;
+
+asciiobj_t* g_wAsciiBird = NULL;
+asciiobj_t* g_wAsciiPipeHeadTop = NULL;
+asciiobj_t* g_wAsciiPipeHeadBot = NULL;
+asciiobj_t* g_wAsciiPipeSection = NULL;
+
+// horizontal extent of ascii pipe columns relative to pipe xpos, union of head and section bounds
+f32 g_wAsciiPipeMinX = 0.0f;
+f32 g_wAsciiPipeMaxX = 0.0f;
+
+pipemesh_t g_wPipeMeshes[PIPE_MESH_SLOTS];
+u64 g_wPipeMeshFrame = 0;
+
+static inline f32 lerpf(f32 a, f32 b, f32 t)
+{
+    return a + (b - a) * t;
+}
+
+// append glyphs of object to info, shifted down by dy
+static u32 appendGlyphs(ascii2info_t* info, const asciiobj_t* object, f32 dy)
+{
+    for (u32 i = 0; i < object->len; i++) {
+        const ascii2_t* chr = object->data.ascii2 + i;
+
+        info[i].charID = chr->charID;
+        info[i].color = g_asciiPalette[chr->color];
+        info[i].pos.x = asciiPosFromFixed(chr->xpos);
+        info[i].pos.y = asciiPosFromFixed(chr->ypos) + dy;
+    }
+
+    return object->len;
+}
+
+// compose pipe column in the layout renderPipes used to draw section by section
+// standing pipes are relative to the pipe top, hanging pipes to the lower end of the pipe
+static asciiobj_t* buildPipeMesh(bool hanging, i32 sections)
+{
+    static ascii2info_t info[O_PIPE_HEAD_BOT_LEN + O_PIPE_HEAD_TOP_LEN + PIPE_MESH_MAX_SECTIONS * O_PIPE_SECTION_LEN];
+
+    rAssert(g_wAsciiPipeSection->len == O_PIPE_SECTION_LEN);
+
+    u32 len = 0;
+
+    if (hanging) {
+        len += appendGlyphs(info + len, g_wAsciiPipeHeadBot, -48.0f);
+
+        for (i32 k = 0; k < sections; k++)
+            len += appendGlyphs(info + len, g_wAsciiPipeSection, -121.0f - 16.0f * (k + 1));
+    } else {
+        len += appendGlyphs(info + len, g_wAsciiPipeHeadTop, 0.0f);
+
+        for (i32 k = 0; k < sections; k++)
+            len += appendGlyphs(info + len, g_wAsciiPipeSection, 16.0f * k);
+    }
+
+    return asciiObject2DIStruct(info, len);
+}
+
+// drop least recently drawn column other than keep that was not drawn this frame
+static bool evictPipeMesh(const pipemesh_t* keep)
+{
+    pipemesh_t* victim = NULL;
+
+    for (u32 i = 0; i < PIPE_MESH_SLOTS; i++) {
+        pipemesh_t* mesh = g_wPipeMeshes + i;
+
+        if (mesh == keep || !mesh->object || mesh->lastUsed == g_wPipeMeshFrame)
+            continue;
+
+        if (!victim || mesh->lastUsed < victim->lastUsed)
+            victim = mesh;
+    }
+
+    if (!victim)
+        return 0;
+
+    removeAsciiObject(victim->object);
+    victim->object = NULL;
+
+    return 1;
+}
+
+// cached column for section count, built on first use, least recently drawn one is replaced
+asciiobj_t* getPipeMesh(bool hanging, i32 sections)
+{
+    pipemesh_t* victim = g_wPipeMeshes;
+
+    sections = SDL_max(0, SDL_min(sections, PIPE_MESH_MAX_SECTIONS));
+
+    for (u32 i = 0; i < PIPE_MESH_SLOTS; i++) {
+        pipemesh_t* mesh = g_wPipeMeshes + i;
+
+        if (mesh->object && mesh->hanging == hanging && mesh->sections == sections) {
+            mesh->lastUsed = g_wPipeMeshFrame;
+            return mesh->object;
+        }
+
+        if (!mesh->object || (victim->object && mesh->lastUsed < victim->lastUsed))
+            victim = mesh;
+    }
+
+    if (victim->object)
+        removeAsciiObject(victim->object);
+
+    victim->object = buildPipeMesh(hanging, sections);
+
+    // glyph pools are shared with all ascii objects, make room from columns that are not on screen
+    while (!victim->object && evictPipeMesh(victim))
+        victim->object = buildPipeMesh(hanging, sections);
+
+    victim->hanging = hanging;
+    victim->sections = sections;
+    victim->lastUsed = g_wPipeMeshFrame;
+
+    return victim->object;
+}
+
+static const sprite_t* snapBird(const worldsnap_t* snap)
+{
+    for (u8 i = 0; i < snap->spriteIdx; i++) {
+        if (snap->sprites[i].spriteType == SPRITE_BIRD)
+            return snap->sprites + i;
+    }
+
+    return NULL;
+}
+
+// ascii objects of the world, rebuilt by the render stage whenever the simulation started a new game
+static void buildAsciiWorld(void)
+{
+    asciiResetAll();
+
+    // reset freed all ascii objects
+    memset(g_wPipeMeshes, 0, sizeof(g_wPipeMeshes));
+
+    g_wAsciiBird = asciiObject2DIStruct(o_asciiBird, O_ASCII_BIRD_LEN);
+    g_wAsciiPipeHeadTop = asciiObject2DIStruct(o_asciiPipeHeadTop, O_PIPE_HEAD_TOP_LEN);
+    g_wAsciiPipeHeadBot = asciiObject2DIStruct(o_asciiPipeHeadBot, O_PIPE_HEAD_BOT_LEN);
+    g_wAsciiPipeSection = asciiObject2DIStruct(o_asciiPipeSection, O_PIPE_SECTION_LEN);
+
+    g_wAsciiPipeMinX = SDL_min(g_wAsciiPipeSection->bmin.x, SDL_min(g_wAsciiPipeHeadTop->bmin.x, g_wAsciiPipeHeadBot->bmin.x));
+    g_wAsciiPipeMaxX = SDL_max(g_wAsciiPipeSection->bmax.x, SDL_max(g_wAsciiPipeHeadTop->bmax.x, g_wAsciiPipeHeadBot->bmax.x));
+}
+
+// hand input to the simulation, it is applied before the next tick
+static void postInput(int set, int flip)
+{
+    int old;
+
+    do {
+        old = SDL_GetAtomicInt(&g_wInputs);
+    } while (!SDL_CompareAndSwapAtomicInt(&g_wInputs, old, (old | set) ^ flip));
+}
+
+// apply input posted since the last step, simulation side
+static void takeInputs(void)
+{
+    int inputs = SDL_SetAtomicInt(&g_wInputs, 0);
+    u32 request = (u32) SDL_GetAtomicInt(&g_wResetRequest);
+
+    // live input is ignored while a replay drives the game
+    if (replayState() == REPLAY_STATE_PLAY) {
+        g_wResetsTaken = request;
+        return;
+    }
+
+    if (request != g_wResetsTaken) {
+        g_wResetsTaken = request;
+        initWorld();
+    }
+
+    if (inputs & SIM_INPUT_GODMODE) {
+        replayRecord(REPLAY_EV_GODMODE, g_world.ticks, 0);
+
+        setGodMode(!g_wGodMode);
+    }
+
+    if ((inputs & SIM_INPUT_UPDRAFT) && g_wResult == GAME_CONTINUE) {
+        replayRecord(REPLAY_EV_UPDRAFT, g_world.ticks, 0);
+
+        g_world.updraft = 1;
+        g_wUpdrafts++;
+    }
+}
+
+// copy state the render stage needs into the back slot and hand it over
+static void publishWorld(void)
+{
+    worldsnap_t* snap = snapBackSlot(&g_wSnapshots);
+
+    memcpy(snap->sprites, g_world.sprites, sizeof(snap->sprites));
+    snap->spriteIdx = g_world.spriteIdx;
+
+    snap->score = g_world.score;
+    snap->result = g_wResult;
+
+    snap->ticks = g_world.ticks;
+    snap->totalTicks = g_wTotalTicks;
+    snap->tickNS = g_wTickNS;
+
+    snap->alpha = (f32) g_wAccumulator / g_wTickNS;
+    snap->publishNS = SDL_GetTicksNS();
+
+    snap->resets = g_wResets;
+    snap->updrafts = g_wUpdrafts;
+    snap->requests = g_wResetsTaken;
+
+    snap->seq = ++g_wPublished;
+
+    snapPublish(&g_wSnapshots);
+}
+
+// run one physics tick with replayed input
+static u32 tickWorld(void)
+{
+    (void) applyReplayEvents();
+
+    g_wTotalTicks++;
+
+    return stepWorld(&g_world, (f32) g_wTickNS / SDL_NS_PER_SECOND);
+}
+
+// steps at tick rate and publishes after every step, never waits for the renderer
+static int SDLCALL simThreadMain(void* data)
+{
+    u64 last = SDL_GetTicksNS();
+
+    while (!SDL_GetAtomicInt(&g_wSimQuit)) {
+        u64 now = SDL_GetTicksNS();
+
+        (void) simulateWorld(now - last);
+
+        last = now;
+
+        // fast forward chunks run back to back, time they took is not simulated again
+        if (replayFastForwardLeft(g_wTotalTicks)) {
+            last = SDL_GetTicksNS();
+            continue;
+        }
+
+        // render interpolates by time, so waking late only delays the next step
+        SDL_DelayNS(g_wTickNS - SDL_min(g_wAccumulator, g_wTickNS));
+    }
+
+    return 0;
+}
+
+// draw latest snapshot, returns its score on game over
+static u32 drawSnapshot(u64 dt)
+{
+    const worldsnap_t* snap = snapLatest(&g_wSnapshots);
+
+    // nothing published yet, or simulation did not take the last reset request yet
+    if (!snap->seq || snap->requests != g_wResetsPosted) {
+        clearScreen(g_wBackgroundColor);
+        return GAME_CONTINUE;
+    }
+
+    if (snap->result != GAME_CONTINUE) {
+        clearScreen(COLOR_BLACK);
+        return snap->result;
+    }
+
+    // ascii objects are only touched here, simulation just counts resets and updrafts
+    if (snap->resets != g_wSeenResets) {
+        buildAsciiWorld();
+        g_wSeenResets = snap->resets;
+    }
+
+    if (snap->updrafts != g_wSeenUpdrafts) {
+        g_wUpdraftAnim = 1;
+        g_wSeenUpdrafts = snap->updrafts;
+    }
+
+    // simulation keeps running after publish, extrapolate its accumulator by the time since
+    f32 alpha = snap->alpha + (f32) (SDL_GetTicksNS() - snap->publishNS) / snap->tickNS;
+
+    renderWorld(snap, SDL_min(alpha, 1.0f), dt);
+
+    return GAME_CONTINUE;
+}
+
+//
+//  Public functions
+//
+void inputUpdraft(void)
+{
+    postInput(SIM_INPUT_UPDRAFT, 0);
+}
+
+void toggleHitboxes(void)
+{
+    g_wShowHitboxes = !g_wShowHitboxes;
+}
+
+void toggleAscii(void)
+{
+    g_wAsciiMode = !g_wAsciiMode;
+
+    if (g_wAsciiMode) {
+        setTextureColor(TEXTURE_CLOUD, COLOR_D_GRAY);
+        g_wBackgroundColor = COLOR_BLACK;
+        g_wTextColor = COLOR_WHITE;
+    } else {    
+        setTextureColor(TEXTURE_CLOUD, COLOR_WHITE);
+        g_wBackgroundColor = COLOR_AZURE;
+        g_wTextColor = COLOR_BLACK;
+    }
+}
+
+void toggleGodMode(void)
+{
+    postInput(0, SIM_INPUT_GODMODE);
+}
+
+// simulation side, or before the simulation thread is started
+void setGodMode(bool enabled)
+{
+    g_wGodMode = enabled;
+    g_world.godMode = enabled;
+}
+
+// start new game with a fresh seed
+void initWorld(void)
+{
+    initWorldSeed(((u64) time(NULL) << 32) ^ SDL_GetTicksNS());
+}
+
+// start new game with given seed, same seed gives same pipes
+void initWorldSeed(u64 seed)
+{
+    replayRecord(REPLAY_EV_RESET, g_world.ticks, seed);
+
+    seedWorld(&g_world, seed);
+    resetWorld(&g_world);
+
+    g_world.godMode = g_wGodMode;
+    g_wAccumulator = 0;
+    g_wResult = GAME_CONTINUE;
+
+    // render stage rebuilds its ascii objects when it sees the new count
+    g_wResets++;
+}
+
+// ask the simulation for a new game, snapshots of the old one are not drawn anymore
+void requestReset(void)
+{
+    SDL_SetAtomicInt(&g_wResetRequest, (int) ++g_wResetsPosted);
+}
+
+// set physics tick rate, takes effect on next update
+void setTickRate(u32 hz)
+{
+    rAssert(hz);
+
+    g_wTickRate = hz;
+    g_wTickNS = SDL_NS_PER_SECOND / hz;
+}
+
+u32 getTickRate(void)
+{
+    return g_wTickRate;
+}
+
+// ticks simulated since start, across resets
+u64 getTotalTicks(void)
+{
+    return g_wTotalTicks;
+}
+
+// apply recorded input due at current tick, returns 1 if a new game was started
+bool applyReplayEvents(void)
+{
+    bool reset = 0;
+    u64 arg;
+    u32 type;
+
+    while ((type = replayPoll(g_world.ticks, &arg)) != REPLAY_EV_NONE) {
+        switch (type) {
+        case REPLAY_EV_RESET:
+            initWorldSeed(arg);
+            reset = 1;
+            break;
+
+        case REPLAY_EV_UPDRAFT:
+            g_world.updraft = 1;
+            g_wUpdrafts++;
+            break;
+
+        case REPLAY_EV_GODMODE:
+            setGodMode(!g_wGodMode);
+            break;
+
+        default:
+            SDL_Log("Replay finished at tick %llu", g_wTotalTicks);
+            replayStop();
+            return reset;
+        }
+    }
+
+    return reset;
+}
+
+// run ticks without rendering until total tick count reaches target, returns score on game over
+u32 fastForwardWorld(u64 target)
+{
+    u32 score;
+
+    while (g_wTotalTicks < target) {
+        if ((score = tickWorld()) != GAME_CONTINUE)
+            return score;
+    }
+
+    g_wAccumulator = 0;
+
+    return GAME_CONTINUE;
+}
+
+// advance simulation by dt (ns) in fixed ticks and publish a snapshot, returns score on game over
+u32 simulateWorld(u64 dt)
+{
+    u64 ffLeft;
+
+    takeInputs();
+
+    // replay continues with next recorded game
+    if (g_wResult != GAME_CONTINUE)
+        (void) applyReplayEvents();
+
+    if (g_wResult == GAME_CONTINUE) {
+        if ((ffLeft = replayFastForwardLeft(g_wTotalTicks))) {
+            // in chunks so render stage keeps getting snapshots
+            g_wResult = fastForwardWorld(g_wTotalTicks + SDL_min(ffLeft, REPLAY_FF_CHUNK));
+        } else {
+            g_wAccumulator += dt;
+
+            // don't try to catch up after long stalls, simulation just slows down
+            if (g_wAccumulator > g_wTickNS * WORLD_MAX_CATCHUP_TICKS)
+                g_wAccumulator = g_wTickNS * WORLD_MAX_CATCHUP_TICKS;
+
+            while (g_wAccumulator >= g_wTickNS) {
+                if ((g_wResult = tickWorld()) != GAME_CONTINUE)
+                    break;
+
+                // a reset replayed inside tickWorld already cleared the accumulator
+                g_wAccumulator -= SDL_min(g_wAccumulator, g_wTickNS);
+            }
+        }
+    }
+
+    // also after game over, render stage waits for the snapshot that took its reset request
+    publishWorld();
+
+    return g_wResult;
+}
+
+// simulate on its own thread from now on, world must only be read through snapshots until stopped
+bool startSimThread(void)
+{
+    if (g_wSimThread)
+        return 1;
+
+    SDL_SetAtomicInt(&g_wSimQuit, 0);
+
+    if (!(g_wSimThread = SDL_CreateThread(simThreadMain, "simulation", NULL))) {
+        SDL_Log("Failed to start simulation thread: %s", SDL_GetError());
+        return 0;
+    }
+
+    return 1;
+}
+
+void stopSimThread(void)
+{
+    if (!g_wSimThread)
+        return;
+
+    SDL_SetAtomicInt(&g_wSimQuit, 1);
+    SDL_WaitThread(g_wSimThread, NULL);
+
+    g_wSimThread = NULL;
+}
+
+// simulate and draw on the calling thread, for benchmarks and when there is no simulation thread
+u32 updateWorld(u64 dt)
+{
+    u32 score;
+
+    profBegin(PROF_ZONE_UPDATE);
+
+    (void) simulateWorld(dt);
+
+    score = drawSnapshot(dt);
+
+    profEnd(PROF_ZONE_UPDATE);
+
+    return score;
+}
+
+// draw whatever the simulation thread published last, returns score on game over
+u32 renderSnapshot(u64 dt)
+{
+    u32 score;
+
+    profBegin(PROF_ZONE_UPDATE);
+
+    score = drawSnapshot(dt);
+
+    profEnd(PROF_ZONE_UPDATE);
+
+    return score;
+}
+
+// latest published result, GAME_CONTINUE while a game runs or a reset is pending
+u32 getWorldResult(void)
+{
+    const worldsnap_t* snap = snapLatest(&g_wSnapshots);
+
+    if (snap->requests != g_wResetsPosted)
+        return GAME_CONTINUE;
+
+    return snap->result;
+}
+
+// render snapshot with sprite positions interpolated between its last two ticks by alpha [0, 1]
+void renderWorld(const worldsnap_t* snap, f32 alpha, u64 dt)
+{
+    const sprite_t* bird = snapBird(snap);
+
+    rAssert(bird);
+
+    if (g_wAsciiMode)
+        handleAnimation(dt);
+
+    clearScreen(g_wBackgroundColor);
+
+    renderClouds(dt);
+    renderPipes(snap, alpha);
+    renderBird(bird, alpha);
+
+    renderSetLayer(RENDER_LAYER_HUD);
+
+    char text[RENDER_U64_MAX_DIGITS + 8] = "Score: ";
+
+    // one cached quad until the score changes
+    (void) renderFormatU64(text + 7, snap->score, 5);
+    renderStrCached(23, 23, 0.25f, g_wTextColor, text);
+
+    if (dt) {
+        // changes every frame, only the label is cached, value is fps with two decimals
+        u64 centiFps = (100 * SDL_NS_PER_SECOND + dt / 2) / dt;
+        u32 len = renderFormatU64(text, centiFps / 100, 0);
+
+        text[len++] = '.';
+        text[len++] = (char) ('0' + centiFps / 10 % 10);
+        text[len++] = (char) ('0' + centiFps % 10);
+        text[len] = '\0';
+
+        renderStrCached(1070, 23, 0.25f, g_wTextColor, "FPS:");
+        renderStrColor(1070 + 5 * 16, 23, 0.25f, g_wTextColor, text);
+    }
+}
+
+void renderClouds(u64 dt)
+{
+    static f32 xpos[3] = {100, 560, 1000};
+
+    profBegin(PROF_ZONE_CLOUDS);
+
+    renderSetLayer(RENDER_LAYER_BACKGROUND);
+
+    for (u8 i = 0; i < 3; i++) {
+        if ((xpos[i] -= ((f32) dt / (7 * SDL_NS_PER_MS))) < -192.0f)
+            xpos[i] = (f32) WINDOW_WIDTH;
+    }
+
+    renderTexture(roundf(xpos[0]), 160, 3, TEXTURE_CLOUD);
+    renderTextureFlip(roundf(xpos[1]), 110, 3, 0, 1, TEXTURE_CLOUD);
+    renderTexture(roundf(xpos[2]), 170, 3, TEXTURE_CLOUD);
+
+    profEnd(PROF_ZONE_CLOUDS);
+}
+
+void renderPipes(const worldsnap_t* snap, f32 alpha)
+{
+    const sprite_t* tmp;
+    f32 xpos, ypos;
+
+    profBegin(PROF_ZONE_PIPES);
+
+    renderSetLayer(RENDER_LAYER_PIPES);
+
+    g_wPipeMeshFrame++;
+
+    for (u8 i = 0; i < snap->spriteIdx; i++) {
+        tmp = snap->sprites + i;
+
+        rAssert(tmp);
+
+        if (tmp->spriteType != SPRITE_PIPE)
+            continue;
+
+        xpos = lerpf(tmp->prevx, tmp->xpos, alpha);
+        ypos = lerpf(tmp->prevy, tmp->ypos, alpha);
+
+        // pipes live until well past the left edge, skip whole columns that are off screen
+        f32 left = g_wAsciiMode ? xpos + g_wAsciiPipeMinX : xpos;
+        f32 right = g_wAsciiMode ? xpos + g_wAsciiPipeMaxX : xpos + tmp->width;
+
+        if (right < 0.0f || left > WINDOW_WIDTH) {
+            profCount(PROF_COUNTER_CULLED_OBJECTS, 1);
+            continue;
+        }
+
+        if (g_wAsciiMode)
+        {
+            asciiobj_t* mesh;
+
+            // section count only changes when randomizePair moves the pipe, so meshes are reused across frames
+            if (ypos < WINDOW_HEIGHT / 2)
+            {
+                mesh = getPipeMesh(1, (i32) roundf((ypos + tmp->height - 126.0f) / 16) + 5);
+
+                if (mesh) {
+                    mesh->xpos = xpos;
+                    mesh->ypos = ypos + tmp->height;
+                }
+            }
+            else
+            {
+                mesh = getPipeMesh(0, (i32) roundf((WINDOW_HEIGHT - ypos) / 16) - 3);
+
+                if (mesh) {
+                    mesh->xpos = xpos;
+                    mesh->ypos = ypos;
+                }
+            }
+
+            if (mesh)
+                renderAsciiObjectDirect2D(mesh);
+        }
+        else
+        {
+            if (ypos < WINDOW_HEIGHT / 2)
+                renderTextureFlip(roundf(xpos), roundf(ypos - tmp->height), 4, 1, 0, TEXTURE_PIPE);
+            else
+                renderTexture(roundf(xpos), roundf(ypos), 4, TEXTURE_PIPE);
+        }
+
+        if (g_wShowHitboxes)
+            renderHitbox(xpos, ypos, tmp->width, tmp->height);
+    }
+
+    profEnd(PROF_ZONE_PIPES);
+}
+
+void renderBird(const sprite_t* bird, f32 alpha)
+{
+    rAssert(bird);
+    rAssert(bird->spriteType == SPRITE_BIRD);
+
+    profBegin(PROF_ZONE_BIRD);
+
+    renderSetLayer(RENDER_LAYER_BIRD);
+
+    f32 xpos = lerpf(bird->prevx, bird->xpos, alpha);
+    f32 ypos = lerpf(bird->prevy, bird->ypos, alpha);
+
+    if (g_wAsciiMode)
+    {
+        g_wAsciiBird->xpos = xpos;
+        g_wAsciiBird->ypos = ypos;
+
+        renderAsciiObjectDirect2D(g_wAsciiBird);
+    }
+    else
+    {
+        renderTexture((i16) roundf(xpos), (i16) roundf(ypos), 4, TEXTURE_BIRD);
+    }
+
+    if (g_wShowHitboxes)
+        renderHitbox(xpos, ypos, bird->width, bird->height);
+
+    profEnd(PROF_ZONE_BIRD);
+}
+
+void handleAnimation(u64 dt)
+{
+    static u64 counter = 0;
+
+    if (g_wUpdraftAnim && !counter) {
+        g_wAsciiBird->data.ascii2[4].ypos = asciiPosToFixed(13.0f);
+        g_wAsciiBird->data.ascii2[5].ypos = asciiPosToFixed(12.0f);
+        asciiUpdateBounds2D(g_wAsciiBird);
+        counter = 1;
+    }
+
+    if (g_wUpdraftAnim) {
+        if ((counter += dt) >= SDL_MS_TO_NS(350)) {
+            g_wAsciiBird->data.ascii2[4].ypos = asciiPosToFixed(9.0f);
+            g_wAsciiBird->data.ascii2[5].ypos = asciiPosToFixed(10.0f);
+            asciiUpdateBounds2D(g_wAsciiBird);
+            g_wUpdraftAnim = 0;
+            counter = 0;
+        }
+    }
+}
\ No newline at end of file
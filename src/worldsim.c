@@ -1,77 +1,108 @@
-#include <math.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
 #include <worldsim.h>
-#include <objects.h>
-#include <render.h>
-#include <ascii.h>
 #include <debug/rdebug.h>
 
-sprite_t g_wSprites[WORLD_MAX_SPRITES];
-u8 g_wSpriteIdx = 0;
+// seed pipe generation, takes effect on next reset
+void seedWorld(world_t* world, u64 seed)
+{
+    rAssert(world);
+
+    rngSeed(&world->rng, seed);
+}
 
-pipepair_t g_wPipes[4];
-u8 g_wPipesIdx = 0;
+// reset world to start of game, rng state carries over so consecutive games differ
+void resetWorld(world_t* world)
+{
+    rAssert(world);
 
-f32 g_wScrollDistance;
+    rng_t rng = world->rng;
 
-bool g_wUpdraft = 0;
-bool g_wShowHitboxes = 0;
-bool g_wGodMode = 0;
+    memset(world, 0, sizeof(world_t));
 
-bool g_wAsciiMode = 0;
-bool g_wUpdraftAnim = 0;
+    world->rng = rng;
 
-u32 g_wTextColor = COLOR_BLACK;
-u32 g_wBackgroundColor = COLOR_AZURE;
+    world->scrollSpeed = WORLD_STD_SCROLL_V;
+    world->score = 100;
 
-asciiobj_t* g_wAsciiBird = NULL;
-asciiobj_t* g_wAsciiPipeHeadTop = NULL;
-asciiobj_t* g_wAsciiPipeHeadBot = NULL;
-asciiobj_t* g_wAsciiPipeSection = NULL;
+    (void) addSprite(world, SPRITE_BIRD, 64, 48, WORLD_STD_BIRD_XPOS, WORLD_STD_BIRD_YPOS);
 
-static inline f32 randRange(i32 lbound, i32 ubound)
+    (void) addPipePair(world, WORLD_STD_FIRST_PIPE_D);
+    (void) addPipePair(world, WORLD_STD_FIRST_PIPE_D + WORLD_STD_PIPE_DISTANCE);
+    (void) addPipePair(world, WORLD_STD_FIRST_PIPE_D + (WORLD_STD_PIPE_DISTANCE * 2));
+}
+
+// advance physics by one tick of dt seconds, no rendering
+u32 stepWorld(world_t* world, f32 dt)
 {
-    rAssert(ubound > lbound);
+    rAssert(world);
+
+    sprite_t* bird = getBird(world);
+
+    rAssert(bird);
+
+    for (u8 i = 0; i < world->spriteIdx; i++) {
+        world->sprites[i].prevx = world->sprites[i].xpos;
+        world->sprites[i].prevy = world->sprites[i].ypos;
+    }
+
+    scrollScreen(world, world->scrollSpeed * dt);
+
+    if ((world->speedupTimer += dt) >= WORLD_STD_SPEEDUP_INTERVAL / 1000.0f) {
+        world->scrollSpeed -= 5.0f;
+        world->score += 100;
+        world->speedupTimer -= WORLD_STD_SPEEDUP_INTERVAL / 1000.0f;
+    }
+
+    handleBirdVerticalSpeed(world, bird, dt, world->updraft);
+
+    world->updraft = 0;
+    world->ticks++;
+
+    if (checkCollision(world, bird) && !world->godMode)
+        return world->score;
 
-    return (f32) (rand() % (lbound - ubound)) + lbound;
+    return GAME_CONTINUE;
 }
 
-sprite_t* addSprite(u32 type, u16 width, u16 height, f32 xpos, f32 ypos)
+sprite_t* addSprite(world_t* world, u32 type, u16 width, u16 height, f32 xpos, f32 ypos)
 {
-    if (g_wSpriteIdx >= WORLD_MAX_SPRITES)
+    rAssert(world);
+
+    if (world->spriteIdx >= WORLD_MAX_SPRITES)
         return NULL;
 
     rAssert(width);
     rAssert(height);
 
-    sprite_t* sprite = g_wSprites + g_wSpriteIdx++;
+    sprite_t* sprite = world->sprites + world->spriteIdx++;
 
     sprite->spriteType = type;
     sprite->width = width;
     sprite->height = height;
     sprite->xpos = xpos;
     sprite->ypos = ypos;
+    sprite->prevx = xpos;
+    sprite->prevy = ypos;
 
     return sprite;
 }
 
-pipepair_t* addPipePair(f32 xpos)
+pipepair_t* addPipePair(world_t* world, f32 xpos)
 {
-    if (g_wPipesIdx >= 4)
+    rAssert(world);
+
+    if (world->pipesIdx >= WORLD_MAX_PIPES)
         return NULL;
 
-    pipepair_t* pair = g_wPipes + g_wPipesIdx++;
+    pipepair_t* pair = world->pipes + world->pipesIdx++;
 
-    pair->top = addSprite(SPRITE_PIPE, WORLD_STD_PIPE_WIDTH, 500, xpos, 0.0f);
-    pair->bot = addSprite(SPRITE_PIPE, WORLD_STD_PIPE_WIDTH, 500, xpos, 0.0f);
+    pair->top = addSprite(world, SPRITE_PIPE, WORLD_STD_PIPE_WIDTH, 500, xpos, 0.0f);
+    pair->bot = addSprite(world, SPRITE_PIPE, WORLD_STD_PIPE_WIDTH, 500, xpos, 0.0f);
 
     rAssert(pair->top && pair->bot);
 
-    randomizePair(pair, 0);
+    randomizePair(world, pair, 0);
 
     return pair;
 }
@@ -88,237 +119,41 @@ void moveSprite(sprite_t* sprite, f32 dx, f32 dy)
         sprite->ypos += dy;
 }
 
-void inputUpdraft(void)
-{
-    g_wUpdraft = 1;
-    g_wUpdraftAnim = 1;
-}
-
-void toggleHitboxes(void)
-{
-    g_wShowHitboxes = !g_wShowHitboxes;
-}
-
-void toggleAscii(void)
+sprite_t* getBird(world_t* world)
 {
-    g_wAsciiMode = !g_wAsciiMode;
-
-    if (g_wAsciiMode) {
-        setTextureColor(TEXTURE_CLOUD, COLOR_D_GRAY);
-        g_wBackgroundColor = COLOR_BLACK;
-        g_wTextColor = COLOR_WHITE;
-    } else {    
-        setTextureColor(TEXTURE_CLOUD, COLOR_WHITE);
-        g_wBackgroundColor = COLOR_AZURE;
-        g_wTextColor = COLOR_BLACK;
-    }
-}
-
-void toggleGodMode(void)
-{
-    g_wGodMode = !g_wGodMode;
-}
-
-void initWorld(void)
-{
-    memset(g_wSprites, 0, sizeof(g_wSprites));
-    memset(g_wPipes, 0, sizeof(g_wPipes));
-
-    g_wSpriteIdx = 0;
-    g_wPipesIdx = 0;
-    g_wScrollDistance = WORLD_STD_SCROLL_V;
-
-    (void) addSprite(SPRITE_BIRD, 64, 48, WORLD_STD_BIRD_XPOS, WORLD_STD_BIRD_YPOS);
-
-    (void) addPipePair(WORLD_STD_FIRST_PIPE_D);
-    (void) addPipePair(WORLD_STD_FIRST_PIPE_D + WORLD_STD_PIPE_DISTANCE);
-    (void) addPipePair(WORLD_STD_FIRST_PIPE_D + (WORLD_STD_PIPE_DISTANCE * 2));
-
-    g_wAsciiBird = asciiObject2DIStruct(o_asciiBird, O_ASCII_BIRD_LEN);
-    g_wAsciiPipeHeadTop = asciiObject2DIStruct(o_asciiPipeHeadTop, O_PIPE_HEAD_TOP_LEN);
-    g_wAsciiPipeHeadBot = asciiObject2DIStruct(o_asciiPipeHeadBot, O_PIPE_HEAD_BOT_LEN);
-    g_wAsciiPipeSection = asciiObject2DIStruct(o_asciiPipeSection, O_PIPE_SECTION_LEN);
-
-    srand(time(NULL));
-}
-
-u32 updateWorld(u64 dt)
-{
-    static u16 scrollTimer = 0;
-    static u16 speedupTimer = 0;
-    static u32 score = 100;
-    static sprite_t* bird = NULL;
-
-    if (!dt) {
-        scrollTimer = 0;
-        speedupTimer = 0;
-        score = 100;
-        bird = NULL;
-    }
-
-    if (!bird)
-        bird = getBird();
-
-    rAssert(bird);
-
-    scrollScreen(g_wScrollDistance * ((f32) dt / 1000));
-
-    if ((speedupTimer += dt) >= WORLD_STD_SPEEDUP_INTERVAL) {
-        g_wScrollDistance -= 5.0f;
-        score += 100;
-        speedupTimer = 0;
-    }
-
-    handleBirdVerticalSpeed(bird, dt, g_wUpdraft);
-
-    g_wUpdraft = 0;
+    rAssert(world);
 
-    if (checkCollision(bird) && !g_wGodMode) {
-        clearScreen(COLOR_BLACK);
-        return score;
-    }
-
-    if (g_wAsciiMode)
-        handleAnimation(dt);
-
-    clearScreen(g_wBackgroundColor);
-
-    renderClouds(dt);
-    renderPipes();
-    renderBird(bird);
-    renderStrColorFmt(23, 23, 0.25f, g_wTextColor, "Score: %5ld", score);
-    renderStrColorFmt(1070, 23, 0.25f, g_wTextColor, "FPS: %.2f", (f32) 1000 / dt);
-
-    return GAME_CONTINUE;
-}
-
-void renderClouds(u64 dt)
-{
-    static f32 xpos[3] = {100, 560, 1000};
-
-    for (u8 i = 0; i < 3; i++) {
-        if ((xpos[i] -= ((f32) dt / 7)) < -192.0f)
-            xpos[i] = (f32) WINDOW_WIDTH;
-    }
-
-    renderTexture(roundf(xpos[0]), 160, 3, TEXTURE_CLOUD);
-    renderTextureFlip(roundf(xpos[1]), 110, 3, 0, 1, TEXTURE_CLOUD);
-    renderTexture(roundf(xpos[2]), 170, 3, TEXTURE_CLOUD);
-}
-
-void renderPipes(void)
-{
-    sprite_t* tmp;
-
-    for (u8 i = 0; i < g_wSpriteIdx; i++) {
-        tmp = g_wSprites + i;
-
-        rAssert(tmp);
-
-        if (tmp->spriteType != SPRITE_PIPE)
-            continue;
-
-        if (g_wAsciiMode)
-        {
-            if (tmp->ypos < WINDOW_HEIGHT / 2)
-            {
-                g_wAsciiPipeHeadBot->xpos = tmp->xpos;
-                g_wAsciiPipeHeadBot->ypos = tmp->ypos + tmp->height - 48.0f;
-
-                g_wAsciiPipeSection->xpos = tmp->xpos;
-                g_wAsciiPipeSection->ypos = tmp->ypos + tmp->height - 121.0f;
-
-                renderAsciiObjectDirect2D(g_wAsciiPipeHeadBot);
-
-                i8 numSections = (i8) roundf((tmp->ypos + tmp->height - 126.0f) / 16) + 5;
-
-                for (i8 k = 0; k < numSections; k++) {
-                    g_wAsciiPipeSection->ypos -= 16.0f;
-                    renderAsciiObjectDirect2D(g_wAsciiPipeSection);
-                }
-            }
-            else
-            {
-                g_wAsciiPipeHeadTop->xpos = tmp->xpos;
-                g_wAsciiPipeHeadTop->ypos = tmp->ypos;
-
-                g_wAsciiPipeSection->xpos = tmp->xpos;
-                g_wAsciiPipeSection->ypos = tmp->ypos;
-
-                renderAsciiObjectDirect2D(g_wAsciiPipeHeadTop);
-
-                i8 numSections = (i8) roundf((WINDOW_HEIGHT - tmp->ypos) / 16) - 3;
-
-                for (i8 k = 0; k < numSections; k++) {
-                    renderAsciiObjectDirect2D(g_wAsciiPipeSection);
-                    g_wAsciiPipeSection->ypos += 16.0f;
-                }
-            }
-        }
-        else
-        {
-            if (tmp->ypos < WINDOW_HEIGHT / 2)
-                renderTextureFlip(roundf(tmp->xpos), roundf(tmp->ypos - tmp->height), 4, 1, 0, TEXTURE_PIPE);
-            else
-                renderTexture(roundf(tmp->xpos), roundf(tmp->ypos), 4, TEXTURE_PIPE);
-        }
-
-        if (g_wShowHitboxes)
-            renderHitbox(tmp->xpos, tmp->ypos, tmp->width, tmp->height);
-    }
-}
-
-void renderBird(sprite_t* bird)
-{
-    rAssert(bird);
-    rAssert(bird->spriteType == SPRITE_BIRD);
-
-    if (g_wAsciiMode)
-    {
-        g_wAsciiBird->xpos = bird->xpos;
-        g_wAsciiBird->ypos = bird->ypos;
-
-        renderAsciiObjectDirect2D(g_wAsciiBird);
-    }
-    else
-    {
-        renderTexture((i16) roundf(bird->xpos), (i16) roundf(bird->ypos), 4, TEXTURE_BIRD);
-    }
-
-    if (g_wShowHitboxes)
-        renderHitbox(bird->xpos, bird->ypos, bird->width, bird->height);
-}
-
-sprite_t* getBird(void)
-{
-    for (u8 i = 0; i < g_wSpriteIdx; i++) {
-        if (g_wSprites[i].spriteType == SPRITE_BIRD)
-            return g_wSprites + i;
+    for (u8 i = 0; i < world->spriteIdx; i++) {
+        if (world->sprites[i].spriteType == SPRITE_BIRD)
+            return world->sprites + i;
     }
 
     return NULL;
 }
 
-void scrollScreen(f32 dx)
+void scrollScreen(world_t* world, f32 dx)
 {
+    rAssert(world);
+
     pipepair_t* tmp;
 
-    for (u8 i = 0; i < g_wPipesIdx; i++) {
-        tmp = g_wPipes + i;
+    for (u8 i = 0; i < world->pipesIdx; i++) {
+        tmp = world->pipes + i;
 
         rAssert(tmp->top->spriteType == SPRITE_PIPE);
         rAssert(tmp->bot->spriteType == SPRITE_PIPE);
 
         if (tmp->top->xpos < -210.0f)
-            randomizePair(tmp, 1);
+            randomizePair(world, tmp, 1);
 
         moveSprite(tmp->top, dx, 0.0f);
         moveSprite(tmp->bot, dx, 0.0f);
     }
 }
 
-void randomizePair(pipepair_t* pair, bool resetXPos)
+void randomizePair(world_t* world, pipepair_t* pair, bool resetXPos)
 {
+    rAssert(world);
     rAssert(pair);
     rAssert(pair->top);
     rAssert(pair->bot);
@@ -328,16 +163,24 @@ void randomizePair(pipepair_t* pair, bool resetXPos)
         pair->bot->xpos = WINDOW_WIDTH + 1.0f;
     }
 
-    f32 gap = randRange(180, 280);
+    f32 gap = rngRange(&world->rng, 180, 280);
 
-    pair->bot->ypos = randRange(WINDOW_HEIGHT / 2, WINDOW_HEIGHT - 70);
+    pair->bot->ypos = rngRange(&world->rng, WINDOW_HEIGHT / 2, WINDOW_HEIGHT - 70);
     pair->top->ypos = pair->bot->ypos - pair->top->height - gap;
+
+    // teleported, don't interpolate from old position
+    pair->top->prevx = pair->top->xpos;
+    pair->top->prevy = pair->top->ypos;
+    pair->bot->prevx = pair->bot->xpos;
+    pair->bot->prevy = pair->bot->ypos;
 }
 
-bool checkCollision(sprite_t* bird)
+bool checkCollision(world_t* world, sprite_t* bird)
 {
+    rAssert(world);
+
     if (!bird)
-        bird = getBird();
+        bird = getBird(world);
 
     rAssert(bird);
     rAssert(bird->spriteType == SPRITE_BIRD);
@@ -345,8 +188,8 @@ bool checkCollision(sprite_t* bird)
 
     sprite_t* tmp;
 
-    for (u8 i = 0; i < g_wSpriteIdx; i++) {
-        tmp = g_wSprites + i;
+    for (u8 i = 0; i < world->spriteIdx; i++) {
+        tmp = world->sprites + i;
 
         if (tmp->spriteType != SPRITE_PIPE)
             continue;
@@ -367,47 +210,22 @@ bool checkCollision(sprite_t* bird)
     return 0;
 }
 
-void handleBirdVerticalSpeed(sprite_t* bird, u64 dt, bool updraft)
+void handleBirdVerticalSpeed(world_t* world, sprite_t* bird, f32 dt, bool updraft)
 {
-    static f32 dy = 0.0f;
-
-    if (!dt) {
-        dy = 0.0f;
-        return;
-    }
+    rAssert(world);
 
     if (!bird)
-        bird = getBird();
+        bird = getBird(world);
 
     rAssert(bird);
     rAssert(bird->spriteType == SPRITE_BIRD);
 
     if (updraft)
-        dy = WORLD_STD_UPDRAFT_V;
-    else if (dy < 0.0f)
-        dy += 3 * WORLD_STD_GRAVITY_DV * (f32) dt / 1000;
+        world->birdSpeed = WORLD_STD_UPDRAFT_V;
+    else if (world->birdSpeed < 0.0f)
+        world->birdSpeed += 3 * WORLD_STD_GRAVITY_DV * dt;
     else
-        dy += WORLD_STD_GRAVITY_DV * (f32) dt / 1000;
-
-    bird->ypos += dy * (f32) dt / 1000;
-}
-
-void handleAnimation(u64 dt)
-{
-    static u32 counter = 0;
+        world->birdSpeed += WORLD_STD_GRAVITY_DV * dt;
 
-    if (g_wUpdraftAnim && !counter) {
-        g_wAsciiBird->data.ascii2[4].ypos = 13.0f;
-        g_wAsciiBird->data.ascii2[5].ypos = 12.0f;
-        counter = 1;
-    }
-
-    if (g_wUpdraftAnim) {
-        if ((counter += dt) >= 350) {
-            g_wAsciiBird->data.ascii2[4].ypos = 9.0f;
-            g_wAsciiBird->data.ascii2[5].ypos = 10.0f;
-            g_wUpdraftAnim = 0;
-            counter = 0;
-        }
-    }
+    bird->ypos += world->birdSpeed * dt;
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include <string.h>
+
+#include <worldsnap.h>
+#include <debug/rdebug.h>
+
+// the three slot indices are always a permutation, so producer and consumer never share a slot
+void snapInit(snapbuf_t* buf)
+{
+    rAssert(buf);
+
+    memset(buf->slots, 0, sizeof(buf->slots));
+
+    SDL_SetAtomicInt(&buf->shared, 0);
+    buf->back = 1;
+    buf->front = 2;
+}
+
+// slot the producer fills, invisible to the consumer until published
+worldsnap_t* snapBackSlot(snapbuf_t* buf)
+{
+    return buf->slots + buf->back;
+}
+
+// hand back slot to consumer, producer continues with whatever slot was shared before
+void snapPublish(snapbuf_t* buf)
+{
+    // SDL_SetAtomicInt is only guaranteed to acquire, snapshot contents must be visible before its index
+    SDL_MemoryBarrierRelease();
+
+    buf->back = (u32) SDL_SetAtomicInt(&buf->shared, (int) (buf->back | SNAP_FRESH)) & SNAP_SLOT_MASK;
+}
+
+// newest published snapshot, stays valid until the next call
+const worldsnap_t* snapLatest(snapbuf_t* buf)
+{
+    // only the consumer clears SNAP_FRESH, a publish in between just hands over an even newer slot
+    if (SDL_GetAtomicInt(&buf->shared) & SNAP_FRESH) {
+        buf->front = (u32) SDL_SetAtomicInt(&buf->shared, (int) buf->front) & SNAP_SLOT_MASK;
+
+        SDL_MemoryBarrierAcquire();
+    }
+
+    return buf->slots + buf->front;
+}